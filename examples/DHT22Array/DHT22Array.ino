@@ -0,0 +1,116 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DHT22 - AM2302/AM2303 multiple sensors example for Arduino
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ *
+ *      On AVR targets, all sensors on the same IO port are read in one transfer. Arduino UNO
+ *      pins 2..7 are on IO port D.
+ */
+
+#include <ErriezDHT22.h>
+#include <ErriezDHT22Array.h>
+
+// Connect DTH22 DAT pins to Arduino DIGITAL pins
+#if defined(ARDUINO_ARCH_AVR) || defined(ARDUINO_SAM_DUE)
+#define DHT22_NUM_SENSORS   6
+const uint8_t dht22Pins[DHT22_NUM_SENSORS] = { 2, 3, 4, 5, 6, 7 };
+#elif defined(ESP8266) || defined(ESP32)
+#define DHT22_NUM_SENSORS   2
+const uint8_t dht22Pins[DHT22_NUM_SENSORS] = { 4, 5 };
+#else
+#error "May work, but not tested on this target"
+#endif
+
+// Create DHT22 sensor objects
+DHT22 *dht22[DHT22_NUM_SENSORS];
+
+// Create DHT22 sensor array
+DHT22Array dht22Array = DHT22Array(dht22, DHT22_NUM_SENSORS);
+
+// Function prototypes
+void printSensor(uint8_t index);
+
+
+void setup()
+{
+    // Initialize serial port
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("DHT22 multiple sensors example\n"));
+
+    // Initialize sensors
+    for (uint8_t i = 0; i < DHT22_NUM_SENSORS; i++) {
+        dht22[i] = new DHT22(dht22Pins[i]);
+        dht22[i]->begin();
+    }
+
+    // Initialize sensor array
+    if (dht22Array.begin()) {
+        Serial.println(F("Sensors are read in one transfer\n"));
+    } else {
+        Serial.println(F("Sensors are read one after another\n"));
+    }
+}
+
+void loop()
+{
+    // Check minimum interval of 2000 ms between sensor reads
+    if (dht22Array.available()) {
+        for (uint8_t i = 0; i < DHT22_NUM_SENSORS; i++) {
+            printSensor(i);
+        }
+        Serial.println();
+    }
+}
+
+void printSensor(uint8_t index)
+{
+    int16_t temperature = dht22[index]->readTemperature();
+    int16_t humidity = dht22[index]->readHumidity();
+
+    Serial.print(F("Sensor "));
+    Serial.print(index);
+    Serial.print(F(": "));
+
+    // Check valid temperature and humidity value
+    if ((temperature == ~0) || (humidity == ~0)) {
+        // Error (Check hardware connection)
+        Serial.println(F("Error"));
+    } else {
+        Serial.print(temperature / 10);
+        Serial.print(F("."));
+        Serial.print(temperature % 10);
+        Serial.print(F(" *C, "));
+        Serial.print(humidity / 10);
+        Serial.print(F("."));
+        Serial.print(humidity % 10);
+        Serial.println(F(" %"));
+    }
+}
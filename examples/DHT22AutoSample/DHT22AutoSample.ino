@@ -0,0 +1,115 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DHT22 - AM2302/AM2303 background sampling example for Arduino
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ *
+ *      The sensor is sampled in the background by update(), called from loop() without delay().
+ *      update() can also be called from a yield() hook or a periodic timer interrupt.
+ *      readTemperature() and readHumidity() never block and return the last successful value.
+ */
+
+#include <ErriezDHT22.h>
+
+// Connect DTH22 DAT pin to Arduino DIGITAL pin
+#if defined(ARDUINO_ARCH_AVR) || defined(ARDUINO_SAM_DUE)
+#define DHT22_PIN      2
+#elif defined(ESP8266) || defined(ESP32)
+#define DHT22_PIN      4 // GPIO4 (Labeled as D2 on some ESP8266 boards)
+#else
+#error "May work, but not tested on this target"
+#endif
+
+// Interval between background conversions in milli seconds
+#define DHT22_SAMPLE_INTERVAL   5000
+
+// Interval between serial prints in milli seconds
+#define PRINT_INTERVAL          1000
+
+// Create DHT22 sensor object
+DHT22 dht22 = DHT22(DHT22_PIN);
+
+
+void setup()
+{
+    // Initialize serial port
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("DHT22 background sampling example\n"));
+
+    // Initialize DHT22
+    dht22.begin();
+
+    // Interrupt capture keeps the other interrupts enabled during the transfer
+    dht22.setCaptureMode(DHT22_CAPTURE_INTERRUPT);
+
+    // Enable background sampling
+    dht22.setAutoSampling(DHT22_SAMPLE_INTERVAL);
+}
+
+void loop()
+{
+    static unsigned long lastPrint;
+
+    // Process background sampling
+    dht22.update();
+
+    // Other work without delay()
+    if ((millis() - lastPrint) < PRINT_INTERVAL) {
+        return;
+    }
+    lastPrint = millis();
+
+    // Check if a new conversion completed
+    if (dht22.available()) {
+        Serial.print(F("New: "));
+    } else {
+        Serial.print(F("Cached: "));
+    }
+
+    // Read last successful temperature and humidity (non-blocking)
+    int16_t temperature = dht22.readTemperature();
+    int16_t humidity = dht22.readHumidity();
+    uint32_t age = dht22.getAge();
+
+    if (age == DHT22_AGE_INVALID) {
+        Serial.println(F("No successful conversion"));
+    } else {
+        Serial.print(temperature / 10);
+        Serial.print(F("."));
+        Serial.print(temperature % 10);
+        Serial.print(F(" *C, "));
+        Serial.print(humidity / 10);
+        Serial.print(F("."));
+        Serial.print(humidity % 10);
+        Serial.print(F(" %, age "));
+        Serial.print(age);
+        Serial.println(F(" ms"));
+    }
+}
@@ -43,18 +43,21 @@
 // Number of temperature and humidity samples for average calculation
 #define DHT22_NUM_SAMPLES         10
 
-// Create DHT22 sensor object
-DHT22 dht22 = DHT22(DHT22_PIN);
-
-int16_t temperatureLast;
-int16_t humidityLast;
+// Create DHT22 sensor object with average samples stored in the object
+DHT22T<DHT22_NUM_SAMPLES> dht22 = DHT22T<DHT22_NUM_SAMPLES>(DHT22_PIN);
 
 // Function prototypes
-void handleTemperature();
-void handleHumidity();
+void handleTemperature(DHT22 *sensor, DHT22Trigger *trigger, int16_t temperature);
+void handleHumidity(DHT22 *sensor, DHT22Trigger *trigger, int16_t humidity);
 void printTemperature(int16_t temperature);
 void printHumidity(int16_t humidity);
 
+// Call the handlers only when the average temperature or humidity changed
+DHT22Trigger temperatureTrigger = DHT22Trigger(DHT22_TRIGGER_CHANGE, DHT22_TRIGGER_TEMPERATURE,
+                                               0, 0, handleTemperature);
+DHT22Trigger humidityTrigger = DHT22Trigger(DHT22_TRIGGER_CHANGE, DHT22_TRIGGER_HUMIDITY,
+                                            0, 0, handleHumidity);
+
 
 void setup()
 {
@@ -66,44 +69,35 @@ void setup()
     Serial.println(F("DHT22 temperature and humidity sensor average example\n"));
 
     // Initialize sensor
-    dht22.begin(DHT22_NUM_SAMPLES);
+    dht22.begin();
+
+    // Register change triggers
+    dht22.addTrigger(&temperatureTrigger);
+    dht22.addTrigger(&humidityTrigger);
 }
 
 void loop()
 {
-    // Check minimum interval of 2000 ms between sensor reads
-    if (dht22.available()) {
-        handleTemperature();
-        handleHumidity();
-    }
+    // Check minimum interval of 2000 ms between sensor reads, the triggers call the handlers
+    dht22.available();
 }
 
-void handleTemperature()
+void handleTemperature(DHT22 *sensor, DHT22Trigger *trigger, int16_t temperature)
 {
-    int16_t temperature;
-
-    // Read temperature
-    temperature = dht22.readTemperature();
+    (void)sensor;
+    (void)trigger;
 
     // Print temperature average
-    if (temperatureLast != temperature) {
-        temperatureLast = temperature;
-        printTemperature(temperature);
-    }
+    printTemperature(temperature);
 }
 
-void handleHumidity()
+void handleHumidity(DHT22 *sensor, DHT22Trigger *trigger, int16_t humidity)
 {
-    int16_t humidity;
+    (void)sensor;
+    (void)trigger;
 
-    // Read humidity
-    humidity = dht22.readHumidity();
-
-    // Print humidity
-    if (humidityLast != humidity) {
-        humidityLast = humidity;
-        printHumidity(humidity);
-    }
+    // Print humidity average
+    printHumidity(humidity);
 }
 
 void printTemperature(int16_t temperature)
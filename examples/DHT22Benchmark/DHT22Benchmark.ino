@@ -0,0 +1,373 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DHT22 - AM2302/AM2303 read latency and CPU time benchmark for Arduino
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ *
+ *      Prints one CSV line per conversion, which can be stored to compare library versions:
+ *          api:            poll (startConversion() / poll()) or read (readSensorData())
+ *          mode:           Capture mode (0: polling, 1: interrupt)
+ *          run:            Run number
+ *          status:         1: Conversion successful, 0: Failed
+ *          total_us:       Wall time of the conversion
+ *          start_us:       Wall time until the last poll() call (poll api only)
+ *          start_cpu_us:   CPU time in all other poll() calls (poll api only)
+ *          transfer_us:    Duration of the last poll() call. This reads the data with interrupts
+ *                          disabled in polling capture mode, or decodes the captured edges in
+ *                          interrupt capture mode (poll api only)
+ *          ack_us:         Duration of the sensor acknowledge in the last poll() call, from the
+ *                          release of the data pin (polling capture mode, poll api only)
+ *          read_us:        Duration of the 40 data bits in the last poll() call, with interrupts
+ *                          disabled (polling capture mode, poll api only)
+ *          cycles_per_bit: CPU clock cycles per data bit of read_us (polling capture mode, poll
+ *                          api only)
+ *          average_ns:     Duration of one DHT22MovingAverage::add() call with a full window of
+ *                          DHT22_NUM_SAMPLES samples
+ *
+ *      The acknowledge and data bits are timed by counting the pulses measured by the library:
+ *      4 pulses for the acknowledge, followed by a low and a high pulse per data bit. Counting
+ *      adds a few clock cycles to each pulse measurement. Retries are disabled, so each line
+ *      contains one transfer.
+ *
+ *      On AVR targets, Timer1 is used as time base, because micros() is not accurate when
+ *      interrupts are disabled longer than 1 ms. Timer1 runs at clock / 64 and wraps after 262 ms
+ *      at 16 MHz.
+ *
+ *      The host tests build this sketch with the mock Arduino HAL and a simulated sensor, see
+ *      test/DHT22Benchmark.cpp. The host durations are simulated time.
+ */
+
+#include <ErriezDHT22.h>
+
+// Connect DTH22 DAT pin to Arduino DIGITAL pin
+#if defined(ARDUINO_ARCH_AVR) || defined(ARDUINO_SAM_DUE) || defined(MOCK_ARDUINO)
+#define DHT22_PIN      2
+#elif defined(ESP8266) || defined(ESP32)
+#define DHT22_PIN      4 // GPIO4 (Labeled as D2 on some ESP8266 boards)
+#else
+#error "May work, but not tested on this target"
+#endif
+
+// Number of temperature and humidity samples for average calculation
+#define DHT22_NUM_SAMPLES         10
+
+// Number of conversions per capture mode and api
+#define BENCHMARK_NUM_RUNS        10
+
+// Number of DHT22MovingAverage::add() calls to measure the average duration
+#define BENCHMARK_NUM_AVERAGE     100
+
+// Number of pulses measured by the polling capture until the first data bit: Release of the data
+// pin, start of the acknowledge, acknowledge low and acknowledge high
+#define BENCHMARK_ACK_PULSES      4
+
+// Function prototypes
+void benchmarkInit();
+uint32_t benchmarkTicks();
+uint32_t benchmarkElapsedTicks(uint32_t start, uint32_t end);
+uint32_t benchmarkTicksToMicros(uint32_t ticks);
+uint32_t benchmarkTicksToCycles(uint32_t ticks);
+uint32_t benchmarkElapsed(uint32_t start);
+uint32_t benchmarkAverage();
+void benchmarkPoll(uint8_t mode, uint8_t run);
+void benchmarkRead(uint8_t mode, uint8_t run);
+void waitReadInterval();
+
+/*!
+ * \brief DHT22 which timestamps the pulses of the polling capture
+ */
+class DHT22Timed : public DHT22
+{
+public:
+    explicit DHT22Timed(uint8_t pin) : DHT22(pin)
+    {
+        resetTimestamps();
+    }
+
+    void resetTimestamps()
+    {
+        _numPulses = 0;
+    }
+
+    bool isTimed()
+    {
+        return _numPulses == (BENCHMARK_ACK_PULSES + (DHT22_NUM_DATA_BITS * 2));
+    }
+
+    uint32_t getAckTicks()
+    {
+        return benchmarkElapsedTicks(_startTicks, _ackTicks);
+    }
+
+    uint32_t getReadTicks()
+    {
+        return benchmarkElapsedTicks(_ackTicks, _readTicks);
+    }
+
+protected:
+    uint32_t measurePulseWidth(uint8_t level)
+    {
+        uint32_t cycles;
+
+        // Only store raw timestamps, interrupts are disabled during the data bits
+        if (_numPulses == 0) {
+            _startTicks = benchmarkTicks();
+        }
+
+        cycles = DHT22::measurePulseWidth(level);
+
+        if (++_numPulses == BENCHMARK_ACK_PULSES) {
+            _ackTicks = benchmarkTicks();
+        } else if (isTimed()) {
+            _readTicks = benchmarkTicks();
+        }
+
+        return cycles;
+    }
+
+private:
+    uint8_t _numPulses;
+    uint32_t _startTicks;
+    uint32_t _ackTicks;
+    uint32_t _readTicks;
+};
+
+// Create DHT22 sensor object
+DHT22Timed dht22 = DHT22Timed(DHT22_PIN);
+
+
+void setup()
+{
+    // Initialize serial port
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+
+    // Initialize sensor
+    dht22.begin(DHT22_NUM_SAMPLES);
+    dht22.setRetries(0);
+
+    // Initialize time base
+    benchmarkInit();
+
+    // Print CSV header
+    Serial.println(F("api,mode,run,status,total_us,start_us,start_cpu_us,transfer_us,"
+                     "ack_us,read_us,cycles_per_bit,average_ns"));
+}
+
+void loop()
+{
+    static uint8_t mode = DHT22_CAPTURE_POLLING;
+    static uint8_t run = 0;
+
+    if (mode > DHT22_CAPTURE_INTERRUPT) {
+        // Benchmark completed
+        return;
+    }
+
+    if (run == 0) {
+        if (!dht22.setCaptureMode(mode)) {
+            // Capture mode not supported by the data pin
+            mode++;
+            return;
+        }
+    }
+
+    benchmarkPoll(mode, run);
+    benchmarkRead(mode, run);
+
+    if (++run >= BENCHMARK_NUM_RUNS) {
+        run = 0;
+        mode++;
+    }
+}
+
+void benchmarkInit()
+{
+#if defined(ARDUINO_ARCH_AVR)
+    // Timer1 free running at clock / 64
+    TCCR1A = 0;
+    TCCR1B = (1 << CS11) | (1 << CS10);
+#endif
+}
+
+uint32_t benchmarkTicks()
+{
+#if defined(ARDUINO_ARCH_AVR)
+    // 16-bit timestamp in clock / 64: Differences are valid up to 262 ms at 16 MHz
+    return TCNT1;
+#else
+    return micros();
+#endif
+}
+
+uint32_t benchmarkElapsedTicks(uint32_t start, uint32_t end)
+{
+#if defined(ARDUINO_ARCH_AVR)
+    return (uint16_t)(end - start);
+#else
+    return end - start;
+#endif
+}
+
+uint32_t benchmarkTicksToMicros(uint32_t ticks)
+{
+#if defined(ARDUINO_ARCH_AVR)
+    return (ticks * 64) / clockCyclesPerMicrosecond();
+#else
+    return ticks;
+#endif
+}
+
+uint32_t benchmarkTicksToCycles(uint32_t ticks)
+{
+#if defined(ARDUINO_ARCH_AVR)
+    return ticks * 64;
+#else
+    return ticks * clockCyclesPerMicrosecond();
+#endif
+}
+
+uint32_t benchmarkElapsed(uint32_t start)
+{
+    return benchmarkTicksToMicros(benchmarkElapsedTicks(start, benchmarkTicks()));
+}
+
+uint32_t benchmarkAverage()
+{
+    static int16_t samples[DHT22_NUM_SAMPLES];
+    DHT22MovingAverage average;
+    volatile int16_t result;
+    uint32_t start;
+
+    // Fill the window, so each add() removes the oldest sample
+    average.begin(samples, DHT22_NUM_SAMPLES);
+    for (uint8_t i = 0; i < DHT22_NUM_SAMPLES; i++) {
+        average.add(dht22.getMeasurement().temperature);
+    }
+
+    start = benchmarkTicks();
+    for (uint8_t i = 0; i < BENCHMARK_NUM_AVERAGE; i++) {
+        result = average.add(i);
+    }
+    start = benchmarkElapsed(start);
+    (void)result;
+
+    return (start * 1000UL) / BENCHMARK_NUM_AVERAGE;
+}
+
+void benchmarkPoll(uint8_t mode, uint8_t run)
+{
+    uint32_t startCpu = 0;
+    uint32_t transfer = 0;
+    uint32_t total;
+    uint32_t call;
+    bool completed;
+
+    waitReadInterval();
+
+    total = benchmarkTicks();
+    dht22.startConversion();
+
+    do {
+        // Only the pulses of the last poll() call are timed
+        dht22.resetTimestamps();
+
+        call = benchmarkTicks();
+        completed = dht22.poll();
+        call = benchmarkElapsed(call);
+
+        if (completed) {
+            transfer = call;
+        } else {
+            startCpu += call;
+        }
+    } while (!completed);
+
+    total = benchmarkElapsed(total);
+
+    Serial.print(F("poll,"));
+    Serial.print(mode);
+    Serial.print(F(","));
+    Serial.print(run);
+    Serial.print(F(","));
+    Serial.print((dht22.getMeasurement().status == DHT22_STATUS_OK) ? 1 : 0);
+    Serial.print(F(","));
+    Serial.print(total);
+    Serial.print(F(","));
+    Serial.print(total - transfer);
+    Serial.print(F(","));
+    Serial.print(startCpu);
+    Serial.print(F(","));
+    Serial.print(transfer);
+    Serial.print(F(","));
+    if (dht22.isTimed()) {
+        Serial.print(benchmarkTicksToMicros(dht22.getAckTicks()));
+        Serial.print(F(","));
+        Serial.print(benchmarkTicksToMicros(dht22.getReadTicks()));
+        Serial.print(F(","));
+        Serial.print(benchmarkTicksToCycles(dht22.getReadTicks()) / DHT22_NUM_DATA_BITS);
+    } else {
+        Serial.print(F(",,"));
+    }
+    Serial.print(F(","));
+    Serial.println(benchmarkAverage());
+}
+
+void benchmarkRead(uint8_t mode, uint8_t run)
+{
+    uint32_t total;
+    bool status;
+
+    waitReadInterval();
+
+    total = benchmarkTicks();
+    status = dht22.readSensorData();
+    total = benchmarkElapsed(total);
+
+    Serial.print(F("read,"));
+    Serial.print(mode);
+    Serial.print(F(","));
+    Serial.print(run);
+    Serial.print(F(","));
+    Serial.print(status ? 1 : 0);
+    Serial.print(F(","));
+    Serial.print(total);
+    Serial.print(F(",,,,,,,"));
+    Serial.println(benchmarkAverage());
+}
+
+void waitReadInterval()
+{
+    static uint32_t lastRead;
+
+    while ((millis() - lastRead) < DHT22_MIN_READ_INTERVAL) {
+        delay(1);
+    }
+    lastRead = millis();
+}
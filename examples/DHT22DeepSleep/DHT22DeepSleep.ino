@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DHT22 - AM2302/AM2303 deep sleep average example for ESP32
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ *
+ *      The ESP32 reads the sensor once after each wake-up and returns to deep sleep. The average
+ *      window is stored in RTC memory, so the average is correct with the first conversion after
+ *      a wake-up, without extra reads.
+ */
+
+#include <ErriezDHT22.h>
+
+// Connect DTH22 DAT pin to Arduino DIGITAL pin
+#if defined(ESP32)
+#define DHT22_PIN      4
+#else
+#error "Unsupported target"
+#endif
+
+// Number of temperature and humidity samples for average calculation
+#define DHT22_NUM_SAMPLES       10
+
+// Deep sleep duration in seconds (minimum 2 seconds between sensor reads)
+#define DEEP_SLEEP_SECONDS      60
+
+// Average window in RTC memory, retained in deep sleep
+DHT22_RETAINED_ATTR DHT22Retained<DHT22_NUM_SAMPLES> dht22Retained;
+
+// Create DHT22 sensor object
+DHT22 dht22 = DHT22(DHT22_PIN);
+
+
+void setup()
+{
+    // Initialize serial port
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("DHT22 deep sleep average example\n"));
+
+    // Initialize sensor and restore average window
+    if (dht22.begin(&dht22Retained)) {
+        Serial.print(F("Average window restored with "));
+        Serial.print(dht22Retained.header.count);
+        Serial.println(F(" samples"));
+    } else {
+        Serial.println(F("Average window cleared"));
+    }
+
+    // Read temperature and humidity
+    if (dht22.readSensorData()) {
+        int16_t temperature = dht22.readTemperature();
+        int16_t humidity = dht22.readHumidity();
+
+        Serial.print(F("Average: "));
+        Serial.print(temperature / 10);
+        Serial.print(F("."));
+        Serial.print(temperature % 10);
+        Serial.print(F(" *C, "));
+        Serial.print(humidity / 10);
+        Serial.print(F("."));
+        Serial.print(humidity % 10);
+        Serial.println(F(" %"));
+    } else {
+        Serial.println(F("Error"));
+    }
+
+    // Deep sleep, setup() is called again after wake-up
+    Serial.flush();
+    esp_sleep_enable_timer_wakeup(DEEP_SLEEP_SECONDS * 1000000ULL);
+    esp_deep_sleep_start();
+}
+
+void loop()
+{
+    // Not reached
+}
@@ -52,7 +52,7 @@
 #define LOG_INTERVAL_MIN      10
 
 // Number of retries after DHT22 read error
-#define DHT22_READ_RETRIES    3
+#define DHT22_READ_RETRIES    2
 
 // CSV files
 #define FILE_VCC_CSV          "vcc.csv"
@@ -463,16 +463,12 @@ bool measure(bool bReadVcc)
 {
     bool retval = true;
 
-    // Read temperature/humidity from DHT22
-    for (uint8_t i = 0; i < DHT22_READ_RETRIES; i++) {
-        dht22Read();
+    // Read temperature/humidity from DHT22, read errors are retried by the library
+    dht22Read();
 
-        if (!dht22IsReadSuccess()) {
-            error(LED_FLASH_DHT22_ERROR, F("DHT22 error"), SLEEP_4S);
-            retval = false;
-        } else {
-            break;
-        }
+    if (!dht22IsReadSuccess()) {
+        error(LED_FLASH_DHT22_ERROR, F("DHT22 error"), SLEEP_4S);
+        retval = false;
     }
 
     // Read date/time from RTC
@@ -582,6 +578,10 @@ void dht22Init()
 {
     // Initialize DHT22
     dht22.begin();
+
+    // Retry read errors within the default retry budget. Retries are DHT22_MIN_READ_INTERVAL
+    // apart, so a failed read keeps the MCU awake for ~4 seconds of the 1 minute alarm interval.
+    dht22.setRetries(DHT22_READ_RETRIES);
 }
 
 void setup()
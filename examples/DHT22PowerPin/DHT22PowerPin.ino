@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DHT22 - AM2302/AM2303 sensor powered from a digital pin example for Arduino
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ *
+ *      Connect the DHT22 VCC pin to a digital pin to power the sensor only for a measurement.
+ *      The sensor is powered on by startConversion() and poll() waits for the warm-up time
+ *      without blocking. The sensor is powered off after each measurement and power cycled after
+ *      consecutive failed conversions.
+ */
+
+#include <ErriezDHT22.h>
+
+// Connect DTH22 DAT pin to Arduino DIGITAL pin and DHT22 VCC pin to the power pin
+#if defined(ARDUINO_ARCH_AVR) || defined(ARDUINO_SAM_DUE)
+#define DHT22_PIN           2
+#define DHT22_POWER_PIN     3
+#elif defined(ESP8266) || defined(ESP32)
+#define DHT22_PIN           4 // GPIO4 (Labeled as D2 on some ESP8266 boards)
+#define DHT22_POWER_PIN     5 // GPIO5 (Labeled as D1 on some ESP8266 boards)
+#else
+#error "May work, but not tested on this target"
+#endif
+
+// Interval between measurements in milli seconds
+#define MEASUREMENT_INTERVAL    60000
+
+// Number of consecutive failed conversions before a power cycle
+#define DHT22_POWER_CYCLE       3
+
+// Create DHT22 sensor object
+DHT22 dht22 = DHT22(DHT22_PIN);
+
+
+void setup()
+{
+    // Initialize serial port
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("DHT22 power pin example\n"));
+
+    // Initialize DHT22
+    dht22.begin();
+
+    // Power sensor from a digital pin, discard the first conversion after power-on
+    dht22.setPowerPin(DHT22_POWER_PIN);
+    dht22.setFirstReadPolicy(DHT22_FIRST_READ_DISCARD);
+    dht22.setPowerCycle(DHT22_POWER_CYCLE);
+}
+
+void loop()
+{
+    static unsigned long lastMeasurement = -MEASUREMENT_INTERVAL;
+
+    // Power-on and start conversion
+    if (dht22.isReady() && ((millis() - lastMeasurement) >= MEASUREMENT_INTERVAL)) {
+        lastMeasurement = millis();
+        dht22.startConversion();
+    }
+
+    // Check if conversion completed
+    if (!dht22.isReady() && dht22.poll()) {
+        // Power-off until the next measurement
+        dht22.powerOff();
+
+        DHT22Measurement measurement = dht22.getMeasurement();
+
+        if (measurement.status == DHT22_STATUS_OK) {
+            Serial.print(measurement.temperature / 10);
+            Serial.print(F("."));
+            Serial.print(measurement.temperature % 10);
+            Serial.print(F(" *C, "));
+            Serial.print(measurement.humidity / 10);
+            Serial.print(F("."));
+            Serial.print(measurement.humidity % 10);
+            Serial.println(F(" %"));
+        } else {
+            Serial.println(F("Error"));
+        }
+    }
+
+    // Do other work or sleep here
+}
@@ -0,0 +1,113 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DHT22 - AM2302/AM2303 dew point, heat index, absolute humidity and humidex example
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ *
+ *      The derived values are calculated with integer arithmetic, no floating point library is
+ *      linked.
+ */
+
+#include <ErriezDHT22.h>
+#include <ErriezDHT22Psychrometrics.h>
+
+// Connect DTH22 DAT pin to Arduino DIGITAL pin
+#if defined(ARDUINO_ARCH_AVR) || defined(ARDUINO_SAM_DUE)
+#define DHT22_PIN      2
+#elif defined(ESP8266) || defined(ESP32)
+#define DHT22_PIN      4 // GPIO4 (Labeled as D2 on some ESP8266 boards)
+#else
+#error "May work, but not tested on this target"
+#endif
+
+// Create DHT22 sensor object
+DHT22 dht22 = DHT22(DHT22_PIN);
+
+// Function prototypes
+void printValue(const __FlashStringHelper *name, int16_t value, const __FlashStringHelper *unit);
+
+
+void setup()
+{
+    // Initialize serial port
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("DHT22 psychrometrics example\n"));
+
+    // Initialize DHT22
+    dht22.begin();
+}
+
+void loop()
+{
+    DHT22Measurement measurement;
+
+    // Check minimum interval of 2000 ms between sensor reads
+    if (dht22.available()) {
+        measurement = dht22.getMeasurement();
+
+        if (measurement.status != DHT22_STATUS_OK) {
+            // Read error (Check hardware connection)
+            Serial.println(F("Read error\n"));
+            return;
+        }
+
+        printValue(F("Temperature"), measurement.temperature, F(" *C"));
+        printValue(F("Humidity"), measurement.humidity, F(" %"));
+        printValue(F("Dew point"),
+                   DHT22Psychrometrics::dewPoint(measurement.temperature, measurement.humidity),
+                   F(" *C"));
+        printValue(F("Heat index"),
+                   DHT22Psychrometrics::heatIndex(measurement.temperature, measurement.humidity),
+                   F(" *C"));
+        printValue(F("Humidex"),
+                   DHT22Psychrometrics::humidex(measurement.temperature, measurement.humidity),
+                   F(" *C"));
+        printValue(F("Absolute humidity"),
+                   DHT22Psychrometrics::absoluteHumidity(measurement.temperature,
+                                                         measurement.humidity),
+                   F(" g/m3"));
+        Serial.println();
+    }
+}
+
+void printValue(const __FlashStringHelper *name, int16_t value, const __FlashStringHelper *unit)
+{
+    // Print value with last digit after the point
+    Serial.print(name);
+    Serial.print(F(": "));
+    if (value < 0) {
+        Serial.print(F("-"));
+        value = -value;
+    }
+    Serial.print(value / 10);
+    Serial.print(F("."));
+    Serial.print(value % 10);
+    Serial.println(unit);
+}
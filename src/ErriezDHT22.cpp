@@ -32,35 +32,157 @@
 
 #include "ErriezDHT22.h"
 
+// Interrupt edge capture, shared by all sensors
+DHT22 *DHT22::_isrInstance = NULL;
+uint8_t DHT22::_widths[DHT22_NUM_DATA_BITS * 2];
+volatile uint8_t DHT22::_numEdges;
+volatile uint8_t DHT22::_numBits;
+volatile uint8_t DHT22::_lowWidth;
+volatile unsigned long DHT22::_lastEdgeTimestamp;
+
+#if defined(DHT22_ICP1_CAPTURE) && defined(DHT22_ICP1_PIN)
+// Timer1 registers, restored after an input capture transfer
+static uint8_t timer1Tccr1a;
+static uint8_t timer1Tccr1b;
+static uint8_t timer1Timsk1;
+
+/*!
+ * \brief Timer1 input capture interrupt.
+ */
+ISR(TIMER1_CAPT_vect)
+{
+    DHT22::icp1ISR();
+}
+#endif
+
 /*!
  * \brief Constructor DHT22 sensor.
  * \param pin Data pin sensor.
  */
 DHT22::DHT22(uint8_t pin) :
-        _temperatureSampleIndex(0), _numTemperatureSamples(0),
-        _humiditySampleIndex(0), _numHumiditySamples(0)
+        _status(DHT22_STATUS_START_ERROR), _numAttempts(0), _numRetries(DHT22_DEFAULT_RETRIES),
+        _numStartErrors(0), _backoff(true), _retryBudget(DHT22_DEFAULT_RETRY_BUDGET),
+        _state(DHT22_STATE_IDLE), _captureMode(DHT22_CAPTURE_POLLING)
 {
     // Store data pin
     _pin = pin;
 
-    // For AVR targets only:
-    // Calculate bit and port register for faster pin reads and writes instead
-    // of using the slow digitalRead() function
-#ifdef __AVR
-    _bit = digitalPinToBitMask(pin);
-    _port = digitalPinToPort(pin);
+    // Average calculation disabled
+    _average = NULL;
+
+#if DHT22_AUTO_SAMPLING
+    // Background sampling disabled
+    _autoInterval = 0;
+    _validTimestamp = 0;
+    _valid = false;
+    _newResult = false;
+    memset(&_newMeasurement, 0, sizeof(_newMeasurement));
+    _newTemperature = 0;
+    _newHumidity = 0;
+    _updating = false;
+#endif
+
+#if DHT22_POWER_CONTROL
+    // No power pin, the sensor is always powered
+    _powerPin = DHT22_POWER_PIN_NONE;
+    _powered = true;
+    _discardFirst = false;
+    _discarding = false;
+    _powerCycle = 0;
+    _numFailures = 0;
+    _warmUpMs = DHT22_POWER_WARM_UP_MS;
+    _powerTimestamp = 0;
+#endif
+
+    // History and triggers disabled
+#if DHT22_HISTORY
+    _history = NULL;
+#endif
+#if DHT22_TRIGGERS
+    _triggers = NULL;
 #endif
 
-    // 1 ms timeout for reading data from DHT22 sensor
+    // Get GPIO input register and bit mask for faster pin reads instead of using the slow
+    // digitalRead() function, when supported by the target
+    _inputRegister = DHT22GpioTraits::inputRegister(pin);
+    _bitMask = DHT22GpioTraits::bitMask(pin);
+
+    // Timeout for reading data from DHT22 sensor until calibrated
     _maxCycles = microsecondsToClockCycles(1000);
+    _bitThreshold = 0;
+
+    // Clear statistics
+    resetStats();
+
+    // No conversion performed
+    _lastMeasurementTimestamp = 0;
+#if DHT22_SNAPSHOT
+    _sequence = 0;
+#endif
+    publishSnapshot();
+}
+
+/*!
+ * \brief Copy constructor DHT22 sensor.
+ * \details
+ *      Copies the configuration and the last result. The copy does not share the average samples,
+ *      retained window, history, triggers or a conversion in progress with the original: Average
+ *      calculation is disabled until begin() of the copy is called.
+ * \param other
+ *      Sensor to copy.
+ */
+DHT22::DHT22(const DHT22 &other)
+{
+    // Nothing allocated yet
+    _average = NULL;
+    _state = DHT22_STATE_IDLE;
+
+    copyFrom(other);
+}
+
+/*!
+ * \brief Assign DHT22 sensor.
+ * \details
+ *      Aborts a conversion in progress, unregisters the triggers and frees the average samples
+ *      allocated by begin(), then copies the sensor as the copy constructor.
+ * \param other
+ *      Sensor to copy.
+ * \return
+ *      This sensor.
+ */
+DHT22 &DHT22::operator=(const DHT22 &other)
+{
+    if (this != &other) {
+        abortConversion();
+        releaseTriggers();
+        releaseAverage();
+
+        copyFrom(other);
+    }
+
+    return *this;
+}
+
+/*!
+ * \brief Destructor DHT22 sensor.
+ * \details
+ *      Aborts a conversion in progress, unregisters the triggers and frees the average samples
+ *      allocated by begin().
+ */
+DHT22::~DHT22()
+{
+    abortConversion();
+    releaseTriggers();
+    releaseAverage();
 }
 
 /*!
  * \brief Initialize sensor.
  * \param numSamples
  *      Number of samples to calculate temperature and humidity average. This allocates
- *      sizeof(int16_t) * number of samples.
- *      Value 0 (default) will disable average calculation.
+ *      2 * sizeof(int16_t) * number of samples on the heap. Samples of a previous begin() call
+ *      are freed. Value 0 (default) will disable average calculation.
+ *      Use DHT22T to store the samples in the object instead.
  * \details
  *      Call this function from setup().\n
  *
@@ -71,19 +193,33 @@ DHT22::DHT22(uint8_t pin) :
  *      - The DHT22 breakout PCB contains a 3k3 pull-up resistor between DAT and VCC.\n
  *      - Please refer to the MCU datasheet or board schematic for more information about IO pin\n
  *        pull-up resistors.
+ *
+ *      The pulse width measurement loop is calibrated with calibrate().
  */
 void DHT22::begin(uint8_t numSamples)
 {
-    // Number of samples for average temperature and humidity calculation
-    _numSamples = numSamples;
-    if (_numSamples) {
-        _temperatureSamples = (int16_t *)malloc(numSamples * sizeof(int16_t));
-        _humiditySamples = (int16_t *)malloc(numSamples * sizeof(int16_t));
+    // Free samples of a previous begin() call
+    releaseAverage();
+
+    // Number of samples for average temperature and humidity calculation, the samples are
+    // stored after the average state
+    if (numSamples) {
+        DHT22Average *average = (DHT22Average *)malloc(sizeof(DHT22Average) +
+                                                       (2 * numSamples * sizeof(int16_t)));
+        if (average != NULL) {
+            int16_t *samples = (int16_t *)&average[1];
+
+            setAverage(average, samples, &samples[numSamples], numSamples);
+            average->allocated = true;
+        }
     }
 
     // Try to enable internal pin pull-up resistor when available
     pinMode(_pin, INPUT_PULLUP);
 
+    // Calibrate pulse timeout and bit threshold in micro seconds
+    calibrate();
+
     // Initialize last measurement timestamp with negative interval to allow a new measurement
     _lastMeasurementTimestamp = (uint32_t)-DHT22_MIN_READ_INTERVAL;
 }
@@ -93,6 +229,11 @@ void DHT22::begin(uint8_t numSamples)
  * \details
  *      The application should call this function and check if a new temperature and humidity can be
  *      read to prevent too fast sensor reads.
+ *
+ *      In background sampling mode, this function does not read the sensor and returns true once
+ *      for each successful conversion by update(). The conversion is then added to the history and
+ *      the triggers are evaluated from this function, so call it from loop(). When more than one
+ *      conversion completed since the last call, only the last conversion is processed.
  * \retval true
  *      Available, interval between sensor reads >= 2000 ms and sensor read was successful.
  * \retval false
@@ -100,6 +241,32 @@ void DHT22::begin(uint8_t numSamples)
  */
 bool DHT22::available()
 {
+#if DHT22_AUTO_SAMPLING
+    if (_autoInterval != 0) {
+        bool newResult;
+        DHT22Measurement measurement;
+        int16_t temperature;
+        int16_t humidity;
+
+        // Background sampling: Report each new result once. The last conversion may have failed
+        // since, so the stored successful result is used.
+        noInterrupts();
+        newResult = _newResult;
+        _newResult = false;
+        measurement = _newMeasurement;
+        temperature = _newTemperature;
+        humidity = _newHumidity;
+        interrupts();
+
+        // update() may run in a timer interrupt, so the history and triggers are processed here
+        if (newResult) {
+            notifyResult(measurement, temperature, humidity);
+        }
+
+        return newResult;
+    }
+#endif
+
     if ((millis() - _lastMeasurementTimestamp) < 2000) {
         // Interval between sensor reads too short
         return false;
@@ -112,7 +279,10 @@ bool DHT22::available()
 /*!
  * \brief Read temperature from sensor.
  * \details
- *      Returns the actual temperature, or a cached temperature when read interval is too short.
+ *      Returns the temperature of the last successful conversion, averaged when enabled with
+ *      begin(). This function has no side effects and can be called multiple times.
+ *      In background sampling mode, the last successful value is also returned after a failed
+ *      conversion, see getAge().
  * \retval Temperature
  *      Signed temperature with last digit after the point.
  * \retval ~0
@@ -120,42 +290,27 @@ bool DHT22::available()
  */
 int16_t DHT22::readTemperature()
 {
-    int16_t temperature = ~0;
-
-    // Read data from sensor
-    if (_statusLastMeasurement != true) {
-        return temperature;
-    }
-
-    // Calculate signed temperature
-    temperature = ((_data[2] & 0x7F) << 8) | _data[3];
-    if (_data[2] & 0x80) {
-        temperature *= -1;
+#if DHT22_AUTO_SAMPLING
+    if ((_autoInterval != 0) && _valid) {
+        // Background sampling: Last successful value
+        return _temperature;
     }
+#endif
 
-    // Calculate temperature average
-    if ((_temperatureSamples != NULL) && (temperature != ~0)) {
-        // Store temperature sample
-        _temperatureSamples[_temperatureSampleIndex++ % _numSamples] = temperature;
-
-        // Increment number of samples
-        if (_numTemperatureSamples < _numSamples) {
-            _numTemperatureSamples++;
-        }
-
-        // Calculate average temperature
-        temperature = 0;
-        for (uint8_t i = 0; i < _numTemperatureSamples; i++) {
-            temperature += _temperatureSamples[i];
-        }
-        temperature /= _numTemperatureSamples;
+    if (_status != DHT22_STATUS_OK) {
+        return ~0;
     }
 
-    return temperature;
+    return _temperature;
 }
 
 /*!
  * \brief Read humidity from sensor.
+ * \details
+ *      Returns the humidity of the last successful conversion, averaged when enabled with
+ *      begin(). This function has no side effects and can be called multiple times.
+ *      In background sampling mode, the last successful value is also returned after a failed
+ *      conversion, see getAge().
  * \retval Humidity
  *      Signed humidity with last digit after the point.
  * \retval ~0
@@ -163,36 +318,165 @@ int16_t DHT22::readTemperature()
  */
 int16_t DHT22::readHumidity()
 {
-    int16_t humidity = ~0;
+#if DHT22_AUTO_SAMPLING
+    if ((_autoInterval != 0) && _valid) {
+        // Background sampling: Last successful value
+        return _humidity;
+    }
+#endif
 
-    // Read data from sensor
-    if (_statusLastMeasurement != true) {
-        return humidity;
+    if (_status != DHT22_STATUS_OK) {
+        return ~0;
     }
 
-    // Calculate humidity
-    humidity = (_data[0] << 8) | _data[1];
+    return _humidity;
+}
 
-    // Calculate temperature average
-    if ((_humiditySamples != NULL) && (humidity != ~0)) {
-        // Store humidity sample
-        _humiditySamples[_humiditySampleIndex++ % _numSamples] = humidity;
+/*!
+ * \brief Read temperature and humidity from sensor with a single call.
+ * \details
+ *      Performs a blocking conversion with readSensorData() and returns the result.
+ * \return
+ *      Conversion result, see getMeasurement().
+ */
+DHT22Measurement DHT22::read()
+{
+    readSensorData();
 
-        // Increment number of samples
-        if (_numHumiditySamples < _numSamples) {
-            _numHumiditySamples++;
-        }
+    return getMeasurement();
+}
 
-        // Calculate average humidity
-        humidity = 0;
-        for (uint8_t i = 0; i < _numHumiditySamples; i++) {
-            humidity += _humiditySamples[i];
-        }
-        humidity /= _numHumiditySamples;
+/*!
+ * \brief Get result of the last conversion.
+ * \details
+ *      Use this function after poll() returns true, or after readSensorData().
+ * \return
+ *      Conversion result. Temperature and humidity are 0 when the status is not DHT22_STATUS_OK.
+ */
+DHT22Measurement DHT22::getMeasurement()
+{
+    DHT22Measurement measurement;
+
+    measurement.status = _status;
+    measurement.attempts = _numAttempts;
+    measurement.timestamp = _lastMeasurementTimestamp;
+
+    if (_status == DHT22_STATUS_OK) {
+        measurement.temperature = _temperature;
+        measurement.humidity = _humidity;
+    } else {
+        measurement.temperature = 0;
+        measurement.humidity = 0;
+    }
+
+    return measurement;
+}
+
+/*!
+ * \brief Get result of the last completed conversion without locking.
+ * \details
+ *      The result is published in two buffers with a sequence counter when a conversion
+ *      completes. Readers copy the buffer which is not being written and retry only when the
+ *      conversion completed during the copy. This can be called from an interrupt or another task
+ *      while update() or poll() completes a conversion, without disabling interrupts.
+ *
+ *      With DHT22_SNAPSHOT set to 0, the result is copied with interrupts disabled instead.
+ * \return
+ *      Conversion result, see getMeasurement().
+ */
+DHT22Measurement DHT22::getSnapshot()
+{
+    DHT22Measurement measurement;
+#if DHT22_SNAPSHOT
+    uint8_t sequence;
+
+    do {
+        sequence = _sequence;
+        DHT22_MEMORY_BARRIER();
+        measurement = _snapshots[sequence & 1];
+        DHT22_MEMORY_BARRIER();
+    } while (sequence != _sequence);
+#else
+    // Consistent with an interrupt, but not with another task on a multi-core target
+    noInterrupts();
+    measurement = getMeasurement();
+    interrupts();
+#endif
+
+    return measurement;
+}
+
+/*!
+ * \brief Store each successful conversion in a history.
+ * \param history
+ *      History with a buffer provided by the application, or NULL to disable.
+ * \details
+ *      The unfiltered temperature and humidity are added with timestamp millis() / 1000 of the
+ *      start of the conversion. In background sampling mode, conversions are added by
+ *      available().
+ */
+#if DHT22_HISTORY
+void DHT22::setHistory(DHT22History *history)
+{
+    _history = history;
+}
+#endif
+
+#if DHT22_TRIGGERS
+/*!
+ * \brief Register a trigger.
+ * \param trigger
+ *      Trigger which is evaluated after each successful conversion, in registration order.
+ * \retval true
+ *      Trigger registered, or already registered to this sensor.
+ * \retval false
+ *      Trigger registered to another sensor.
+ */
+bool DHT22::addTrigger(DHT22Trigger *trigger)
+{
+    DHT22Trigger **link = &_triggers;
+
+    if (trigger->_owner == this) {
+        // Already registered
+        return true;
+    }
+    if (trigger->_owner != NULL) {
+        // Linked in the list of another sensor
+        return false;
+    }
+
+    // Append to the list, triggers are evaluated in registration order
+    while (*link != NULL) {
+        link = &(*link)->_next;
     }
 
-    return humidity;
+    trigger->_owner = this;
+    trigger->_next = NULL;
+    *link = trigger;
+
+    return true;
+}
+
+/*!
+ * \brief Unregister a trigger.
+ * \param trigger
+ *      Trigger registered with addTrigger().
+ */
+void DHT22::removeTrigger(DHT22Trigger *trigger)
+{
+    DHT22Trigger **link = &_triggers;
+
+    while (*link != NULL) {
+        if (*link == trigger) {
+            *link = trigger->_next;
+            trigger->_owner = NULL;
+            trigger->_next = NULL;
+            return;
+        }
+        link = &(*link)->_next;
+    }
 }
+#endif
 
 /*!
  * \brief Read data from sensor.
@@ -204,6 +488,9 @@ int16_t DHT22::readHumidity()
  *      - A valid start condition
  *      - A successful sensor read (5 Bytes data)
  *      - A correct checksum
+ *
+ *      This is a blocking wrapper around startConversion() and poll(). The worst-case duration is
+ *      limited by the retry budget, see setRetries(), plus the sensor warm-up with setPowerPin().
  * \retval true
  *      Last conversion was successful.
  * \retval false
@@ -211,158 +498,1538 @@ int16_t DHT22::readHumidity()
  */
 bool DHT22::readSensorData()
 {
-    // Store last conversion timestamp
-    _lastMeasurementTimestamp = millis();
+    // Start conversion and wait until completed
+    startConversion();
+    while (!poll()) {
+        yield();
+    }
 
-    // Read data from sensor until valid data has been read or maximum number of retries
-    // Mark current measurement as successful
-    _statusLastMeasurement = true;
+    return (_status == DHT22_STATUS_OK);
+}
 
-    // Generate sensor start pulse
-    if (generateStart() != true) {
-        DEBUG_PRINTLN(F("DHT22: Start error"));
-        // Mark measurement as invalid
-        _statusLastMeasurement = false;
-    }
+/*!
+ * \brief Start a non-blocking conversion.
+ * \details
+ *      Call poll() repeatedly from loop() until the conversion is completed. A conversion in
+ *      progress is restarted.
+ */
+void DHT22::startConversion()
+{
+    // Release the edge capture of a conversion in progress
+    abortConversion();
 
-    // Read 5 Bytes data from sensor
-    if (_statusLastMeasurement) {
-        if (readBytes() != true) {
-            DEBUG_PRINTLN(F("DHT22: Read error"));
-            // Mark measurement as invalid
-            _statusLastMeasurement = false;
+    // Skip a sensor without acknowledge until the backoff interval elapsed. The interval doubles
+    // with each failed conversion, starting at DHT22_MIN_READ_INTERVAL.
+    if (_backoff && (_numStartErrors > 0)) {
+        uint8_t shift = (_numStartErrors < DHT22_BACKOFF_MAX_SHIFT) ?
+                        _numStartErrors : DHT22_BACKOFF_MAX_SHIFT;
+
+        if ((millis() - _lastMeasurementTimestamp) < ((uint32_t)DHT22_MIN_READ_INTERVAL << shift)) {
+            // Keep the last error status
+            _numAttempts = 0;
+            return;
         }
     }
 
-    // Check data parity
-    if (_statusLastMeasurement) {
-        if (((_data[0] + _data[1] + _data[2] + _data[3]) & 0xFF) != _data[4]) {
-            DEBUG_PRINTLN(F("DHT22: Parity error"));
-            // Mark measurement as invalid
-            _statusLastMeasurement = false;
-        }
+    _numAttempts = 1;
+
+#if DHT22_POWER_CONTROL
+    if ((_powerPin != DHT22_POWER_PIN_NONE) &&
+        (!_powered || _discarding || ((millis() - _powerTimestamp) < _warmUpMs))) {
+        // Power-on and warm-up in poll(), the timestamp is stored at the start condition
+        _state = DHT22_STATE_WARM_UP;
+        return;
     }
+#endif
+
+    // Store last conversion timestamp
+    _lastMeasurementTimestamp = millis();
 
-    return _statusLastMeasurement;
+    startCondition();
 }
 
-//--------------------------------------------------------------------------------------------------
-// Private functions
-//--------------------------------------------------------------------------------------------------
 /*!
- * \brief Generate start pulses to start data read.
+ * \brief Process a non-blocking conversion.
+ * \details
+ *      This function returns immediately during the sensor warm-up and the start condition. The
+ *      last call performs the synchronous data transfer with global interrupts disabled (~5 ms).
  * \retval true
- *      Success, continue with reading temperature and humidity bytes.
+ *      No conversion in progress, the result is available with readTemperature() and
+ *      readHumidity().
  * \retval false
- *      Failure, the sensor did not respond.
+ *      Conversion in progress.
  */
-bool DHT22::generateStart()
+bool DHT22::poll()
 {
-    // Data pin high (pull-up)
-    digitalWrite(_pin, HIGH);
-    delay(10);
+    switch (_state) {
+#if DHT22_POWER_CONTROL
+        case DHT22_STATE_WARM_UP:
+            if (!_powered) {
+                // Keep the sensor power off long enough for a reset
+                if ((millis() - _powerTimestamp) < DHT22_POWER_OFF_MS) {
+                    return false;
+                }
+                powerOn();
+            }
 
-    // Change data pin to output, low, followed by high
-    pinMode(_pin, OUTPUT);
-    digitalWrite(_pin, LOW);
-    delay(20);
+            // Wait for the sensor warm-up, and the read interval after a discarded conversion
+            if (((millis() - _powerTimestamp) < _warmUpMs) ||
+                ((millis() - _lastMeasurementTimestamp) < DHT22_MIN_READ_INTERVAL)) {
+                return false;
+            }
 
-    // Data pin to input (pull-up)
-    pinMode(_pin, INPUT_PULLUP);
-    delayMicroseconds(30);
+            // Store last conversion timestamp
+            _lastMeasurementTimestamp = millis();
 
-    // Check data pin timing low
-    if (measurePulseWidth(LOW) == 0) {
+            // Completes the conversion on a bus error
+            startCondition();
+            return isReady();
+#endif
+
+        case DHT22_STATE_RETRY:
+            // The sensor does not respond to a start condition within DHT22_MIN_READ_INTERVAL of
+            // the previous attempt
+            if ((millis() - _lastMeasurementTimestamp) <
+                ((uint32_t)(_numAttempts - 1) * DHT22_MIN_READ_INTERVAL)) {
+                return false;
+            }
+
+            // Completes the conversion on a bus error
+            startCondition();
+            return isReady();
+
+        case DHT22_STATE_START_HIGH:
+            if ((micros() - _stateTimestamp) < DHT22_START_HIGH_US) {
+                return false;
+            }
+
+            // Change data pin to output, low
+            pinMode(_pin, OUTPUT);
+            digitalWrite(_pin, LOW);
+
+            _state = DHT22_STATE_START_LOW;
+            _stateTimestamp = micros();
+            return false;
+
+        case DHT22_STATE_START_LOW:
+            if ((micros() - _stateTimestamp) < DHT22_START_LOW_US) {
+                return false;
+            }
+
+            if (_captureMode != DHT22_CAPTURE_POLLING) {
+                // Keep data pin low while another sensor is capturing
+                if (startEdgeCapture() != true) {
+                    return false;
+                }
+
+                _state = DHT22_STATE_CAPTURE;
+                _stateTimestamp = micros();
+                return false;
+            }
+
+            // Read sensor acknowledge, data and parity
+            completeConversion();
+
+            return finishConversion();
+
+        case DHT22_STATE_CAPTURE:
+            if ((_numEdges < DHT22_NUM_EDGES) &&
+                ((micros() - _stateTimestamp) < DHT22_CAPTURE_TIMEOUT_US) &&
+                ((_numEdges > 0) || ((micros() - _stateTimestamp) < DHT22_PULSE_TIMEOUT_US))) {
+                // Capture in progress, abort early without sensor acknowledge
+                return false;
+            }
+
+            stopEdgeCapture();
+
+            // Decode captured edges and check parity
+            completeConversion();
+
+            return finishConversion();
+
+        default:
+            return true;
+    }
+}
+
+/*!
+ * \brief Check if a conversion is in progress.
+ * \retval true
+ *      No conversion in progress.
+ * \retval false
+ *      Conversion in progress, call poll().
+ */
+bool DHT22::isReady()
+{
+    return (_state == DHT22_STATE_IDLE);
+}
+
+/*!
+ * \brief Select capture mode of the data transfer.
+ * \param captureMode
+ *      DHT22_CAPTURE_POLLING: Busy-wait pulse width measurement with interrupts disabled (default).\n
+ *      DHT22_CAPTURE_INTERRUPT: Timestamp each data pin edge in a pin change interrupt with
+ *      attachInterrupt(). Interrupts stay enabled during the transfer.\n
+ *      DHT22_CAPTURE_ICP1: Timestamp each data pin edge with the AVR Timer1 input capture unit.
+ *      Requires DHT22_ICP1_CAPTURE and the data pin connected to ICP1.
+ * \retval true
+ *      Capture mode selected.
+ * \retval false
+ *      Conversion in progress, invalid capture mode or data pin does not support the capture
+ *      mode.
+ */
+bool DHT22::setCaptureMode(uint8_t captureMode)
+{
+    // Capture mode cannot be changed during a conversion
+    if (!isReady()) {
         return false;
     }
 
-    // Check data pin timing high
-    if (measurePulseWidth(HIGH) == 0) {
+    if (captureMode == DHT22_CAPTURE_INTERRUPT) {
+#ifdef NOT_AN_INTERRUPT
+        if (digitalPinToInterrupt(_pin) == NOT_AN_INTERRUPT) {
+            return false;
+        }
+#endif
+    } else if (captureMode == DHT22_CAPTURE_ICP1) {
+#if defined(DHT22_ICP1_CAPTURE) && defined(DHT22_ICP1_PIN)
+        if (_pin != DHT22_ICP1_PIN) {
+            return false;
+        }
+#else
+        return false;
+#endif
+    } else if (captureMode != DHT22_CAPTURE_POLLING) {
         return false;
     }
 
-    // Sensor start successfully generated
+    _captureMode = captureMode;
+
     return true;
 }
 
 /*!
- * \brief Read humidity, temperature and parity bytes from sensor.
+ * \brief Calibrate pulse width measurement loop.
  * \details
- *      Global interrupts are disabled during pin measurement, because the timing in micro seconds
- *      is very critical.
+ *      Measures the number of measurePulseWidth() loop iterations per micro second while the data
+ *      pin is idle high. The loop time depends on the CPU clock, the GPIO backend and the
+ *      compiler. The pulse timeout (DHT22_PULSE_TIMEOUT_US) and bit threshold
+ *      (DHT22_BIT_THRESHOLD_US) are converted to loop iterations, so a failed read aborts as soon
+ *      as the sensor stops responding.
+ *
+ *      Called by begin(). Takes ~2 ms with interrupts enabled.
  * \retval true
- *      Read bytes successful.
+ *      Calibration successful.
  * \retval false
- *      Incorrect timing sensor data pin received.
+ *      Data pin low or conversion in progress, the uncalibrated timeout of 1 ms CPU clock cycles
+ *      is used.
  */
-bool DHT22::readBytes()
+bool DHT22::calibrate()
 {
-    // Disable interrupts during data transfer
-    noInterrupts();
-
-    // Measure and store pulse width of each bit
-    for (int i = 0; i < (DHT22_NUM_DATA_BITS * 2); i += 2) {
-        cycles[i] = measurePulseWidth(LOW);
-        cycles[i + 1] = measurePulseWidth(HIGH);
-    }
+    uint32_t loops = 256;
+    uint32_t loopsPerUsQ8;
+    unsigned long start;
+    unsigned long duration;
 
-    // Enable interrupts
-    interrupts();
+    // Uncalibrated timeout
+    _maxCycles = microsecondsToClockCycles(1000);
+    _bitThreshold = 0;
 
-    // Clear data buffer
-    memset(_data, 0, sizeof(_data));
+    // Data pin must be idle high
+    if (!isReady() || (digitalRead(_pin) != HIGH)) {
+        return false;
+    }
 
-    // Convert pulse width to data bit
-    for (int i = 0; i < DHT22_NUM_DATA_BITS; ++i) {
-        uint32_t lowCycles = cycles[2 * i];
-        uint32_t highCycles = cycles[(2 * i) + 1];
+    // Increase number of loops until the measurement takes long enough
+    do {
+        loops *= 2;
+        _maxCycles = loops;
 
-        // Check valid bit timing
-        if ((lowCycles == 0) || (highCycles == 0)) {
+        start = micros();
+        if (measurePulseWidth(HIGH) != 0) {
+            // Data pin changed during calibration
+            _maxCycles = microsecondsToClockCycles(1000);
             return false;
         }
+        duration = micros() - start;
+    } while ((duration < DHT22_CALIBRATION_US) && (loops < 0x1000000UL));
 
-        // Calculate byte index in data array
-        int byteIndex = i / 8;
-
-        // Store bit
-        _data[byteIndex] <<= 1;
-        if (highCycles > lowCycles) {
-            _data[byteIndex] |= 1;
-        }
+    if (duration == 0) {
+        _maxCycles = microsecondsToClockCycles(1000);
+        return false;
     }
 
+    // Loops per micro second in 24.8 fixed point
+    loopsPerUsQ8 = ((loops / duration) << 8) + (((loops % duration) << 8) / duration);
+
+    _maxCycles = (DHT22_PULSE_TIMEOUT_US * loopsPerUsQ8) >> 8;
+    _bitThreshold = (DHT22_BIT_THRESHOLD_US * loopsPerUsQ8) >> 8;
+
     return true;
 }
 
 /*!
- * \brief Measure data pin pulse width.
- * \param level Measure data signal low or high.
- * \retval Pin timing
- *      Sensor data pin timing in us.
- * \retal 0
- *      Timeout
+ * \brief Configure read retries after a timeout or parity error.
+ * \param numRetries
+ *      Maximum number of retries, 0 disables retries. Default is DHT22_DEFAULT_RETRIES.
+ * \param budgetMs
+ *      Maximum duration of a conversion including all retries in milli seconds. A retry is only
+ *      started when it completes within the budget, assuming DHT22_CONVERSION_MAX_MS per attempt.
+ *      Default is DHT22_DEFAULT_RETRY_BUDGET, which allows the default retries.
+ * \details
+ *      The sensor does not respond within DHT22_MIN_READ_INTERVAL of the previous read, so retry n
+ *      is started n * DHT22_MIN_READ_INTERVAL after the first attempt. The worst-case duration of
+ *      readSensorData() is the budget, or numRetries * DHT22_MIN_READ_INTERVAL +
+ *      DHT22_CONVERSION_MAX_MS when that is shorter. A budget below DHT22_MIN_READ_INTERVAL +
+ *      DHT22_CONVERSION_MAX_MS disables retries. A conversion without sensor acknowledge is not
+ *      retried.
  */
-uint32_t DHT22::measurePulseWidth(uint8_t level)
+void DHT22::setRetries(uint8_t numRetries, uint16_t budgetMs)
 {
-    uint32_t count = 0;
+    _numRetries = numRetries;
+    _retryBudget = budgetMs;
+}
 
-#ifdef __AVR
-    while ((*portInputRegister(_port) & _bit) == (level ? _bit : 0)) {
-      if (count++ >= _maxCycles) {
-        // Timeout
-        return 0;
-      }
+/*!
+ * \brief Enable or disable backoff of sensors without acknowledge.
+ * \param enable
+ *      true (default): After a start or bus error, conversions are skipped for
+ *      DHT22_MIN_READ_INTERVAL * 2^n ms (n = consecutive errors, maximum DHT22_BACKOFF_MAX_SHIFT).
+ *      A skipped conversion completes immediately with the last error status and 0 attempts.\n
+ *      false: Each conversion generates a start condition.
+ */
+void DHT22::setBackoff(bool enable)
+{
+    _backoff = enable;
+}
+
+#if DHT22_AUTO_SAMPLING
+/*!
+ * \brief Enable or disable background sampling.
+ * \details
+ *      Conversions are started and completed by update(). Do not call readSensorData(),
+ *      startConversion() or poll() while background sampling is enabled.
+ * \param intervalMs
+ *      Interval between conversions in milli seconds, minimum DHT22_MIN_READ_INTERVAL.
+ *      0 disables background sampling.
+ */
+void DHT22::setAutoSampling(uint32_t intervalMs)
+{
+    if ((intervalMs != 0) && (intervalMs < DHT22_MIN_READ_INTERVAL)) {
+        intervalMs = DHT22_MIN_READ_INTERVAL;
     }
 
+    _newResult = false;
+    _autoInterval = intervalMs;
+}
+
+/*!
+ * \brief Process background sampling.
+ * \details
+ *      Starts a conversion when the sampling interval elapsed and completes it with poll(). Until
+ *      the first successful conversion, conversions are started every DHT22_MIN_READ_INTERVAL.
+ *      Call this function from loop(), from a yield() hook, or from a periodic timer interrupt of
+ *      ~1 ms. From a timer interrupt, use DHT22_CAPTURE_INTERRUPT, because the polling capture
+ *      mode blocks ~5 ms, and do not define DEBUG_PRINT, because errors are printed to Serial.
+ *      The history and triggers are processed by available(), not by this function.
+ * \retval true
+ *      A new successful conversion completed.
+ * \retval false
+ *      No new result, or background sampling disabled.
+ */
+bool DHT22::update()
+{
+    bool newResult = false;
+
+    // Ignore re-entrant calls from yield() or a timer interrupt
+    if ((_autoInterval == 0) || _updating) {
+        return false;
+    }
+    _updating = true;
+
+    if (isReady()) {
+        if ((millis() - _lastMeasurementTimestamp) >=
+            (_valid ? _autoInterval : DHT22_MIN_READ_INTERVAL)) {
+            // Completes immediately when skipped by the backoff
+            startConversion();
+        }
+    } else if (poll() && (_status == DHT22_STATUS_OK)) {
+        _newResult = true;
+        newResult = true;
+    }
+
+    _updating = false;
+
+    return newResult;
+}
+#endif
+
+#if DHT22_POWER_CONTROL
+/*!
+ * \brief Power the sensor from a digital pin.
+ * \details
+ *      Call this function after begin(). The sensor is powered off until powerOn() or the next
+ *      conversion. A conversion waits without blocking poll() until the warm-up time after
+ *      power-on elapsed. readSensorData() blocks during the warm-up.
+ * \param powerPin
+ *      Digital pin connected to the sensor VCC, DHT22_POWER_PIN_NONE to disable power control.
+ * \param warmUpMs
+ *      Sensor warm-up time after power-on in milli seconds.
+ */
+void DHT22::setPowerPin(uint8_t powerPin, uint16_t warmUpMs)
+{
+    _powerPin = powerPin;
+    _warmUpMs = warmUpMs;
+
+    if (_powerPin == DHT22_POWER_PIN_NONE) {
+        _powered = true;
+        _discarding = false;
+    } else {
+        pinMode(_powerPin, OUTPUT);
+        powerOff();
+    }
+}
+
+/*!
+ * \brief Set use of the first conversion after power-on.
+ * \param policy
+ *      DHT22_FIRST_READ_KEEP (default): Use the first conversion.\n
+ *      DHT22_FIRST_READ_DISCARD: Discard the first conversion and convert again after
+ *      DHT22_MIN_READ_INTERVAL, because the first data after power-on may be invalid.
+ */
+void DHT22::setFirstReadPolicy(uint8_t policy)
+{
+    _discardFirst = (policy == DHT22_FIRST_READ_DISCARD);
+}
+
+/*!
+ * \brief Power cycle the sensor after consecutive failed conversions.
+ * \details
+ *      The sensor is powered off for at least DHT22_POWER_OFF_MS and powered on by the next
+ *      conversion. Requires setPowerPin().
+ * \param numFailures
+ *      Number of consecutive failed conversions, 0 (default) disables power cycling.
+ */
+void DHT22::setPowerCycle(uint8_t numFailures)
+{
+    _powerCycle = numFailures;
+    _numFailures = 0;
+}
+
+/*!
+ * \brief Power the sensor on and start the warm-up time.
+ */
+void DHT22::powerOn()
+{
+    if ((_powerPin == DHT22_POWER_PIN_NONE) || _powered) {
+        return;
+    }
+
+    digitalWrite(_powerPin, HIGH);
+    pinMode(_pin, INPUT_PULLUP);
+
+    _powered = true;
+    _discarding = _discardFirst;
+    _powerTimestamp = millis();
+}
+
+/*!
+ * \brief Power the sensor off.
+ * \details
+ *      The data pin is changed to input without pull-up, so the sensor is not powered through the
+ *      data pin. A conversion in progress is aborted.
+ */
+void DHT22::powerOff()
+{
+    if (_powerPin == DHT22_POWER_PIN_NONE) {
+        return;
+    }
+
+    abortConversion();
+
+    pinMode(_pin, INPUT);
+    digitalWrite(_powerPin, LOW);
+
+    _powered = false;
+    _discarding = false;
+    _powerTimestamp = millis();
+}
+#endif
+
+#if DHT22_AUTO_SAMPLING
+/*!
+ * \brief Get age of the last successful conversion.
+ * \return
+ *      Milli seconds since the start of the last successful conversion, or DHT22_AGE_INVALID
+ *      when no conversion was successful.
+ */
+uint32_t DHT22::getAge()
+{
+    if (!_valid) {
+        return DHT22_AGE_INVALID;
+    }
+
+    return millis() - _validTimestamp;
+}
+#endif
+
+/*!
+ * \brief Get number of retries of the last conversion.
+ * \return
+ *      Number of retries after the first read attempt.
+ */
+uint8_t DHT22::getNumRetriesLastConversion()
+{
+    return (_numAttempts > 0) ? (_numAttempts - 1) : 0;
+}
+
+/*!
+ * \brief Get conversion error and timing statistics.
+ * \param stats
+ *      Statistics output. Cleared when statistics are not enabled.
+ * \retval true
+ *      Statistics available.
+ * \retval false
+ *      Statistics not enabled, define DHT22_STATS in ErriezDHT22.h.
+ */
+bool DHT22::getStats(DHT22Stats *stats)
+{
+#ifdef DHT22_STATS
+    *stats = _stats;
+
+    return true;
 #else
-    while (digitalRead(_pin) == level) {
-        if (count++ >= _maxCycles) {
-            // Timeout
-            return 0;
+    memset(stats, 0, sizeof(DHT22Stats));
+
+    return false;
+#endif
+}
+
+/*!
+ * \brief Clear conversion error and timing statistics.
+ */
+void DHT22::resetStats()
+{
+#ifdef DHT22_STATS
+    memset(&_stats, 0, sizeof(_stats));
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+// Protected functions
+//--------------------------------------------------------------------------------------------------
+/*!
+ * \brief Enable temperature and humidity average calculation.
+ * \param average
+ *      Average state, or NULL to disable average calculation.
+ * \param temperatureSamples
+ *      Temperature sample buffer with numSamples elements.
+ * \param humiditySamples
+ *      Humidity sample buffer with numSamples elements.
+ * \param numSamples
+ *      Number of samples in the window.
+ */
+void DHT22::setAverage(DHT22Average *average, int16_t *temperatureSamples,
+                       int16_t *humiditySamples, uint8_t numSamples)
+{
+    releaseAverage();
+
+    if (average != NULL) {
+        average->temperature.begin(temperatureSamples, numSamples);
+        average->humidity.begin(humiditySamples, numSamples);
+        average->retained = NULL;
+        average->allocated = false;
+    }
+
+    _average = average;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Moving average
+//--------------------------------------------------------------------------------------------------
+/*!
+ * \brief Initialize moving average filter.
+ * \param samples
+ *      Sample buffer with numSamples elements, or NULL to disable average calculation.
+ * \param numSamples
+ *      Number of samples in the window.
+ */
+void DHT22MovingAverage::begin(int16_t *samples, uint8_t numSamples)
+{
+    _samples = samples;
+    _size = (samples != NULL) ? numSamples : 0;
+    _index = 0;
+    _count = 0;
+    _sum = 0;
+}
+
+/*!
+ * \brief Restore moving average filter from retained samples.
+ * \param samples
+ *      Sample buffer with numSamples elements.
+ * \param numSamples
+ *      Number of samples in the window.
+ * \param index
+ *      Index in the sample buffer for the next sample.
+ * \param count
+ *      Number of samples in the sample buffer.
+ * \retval true
+ *      Restored, the sum is recalculated from the samples.
+ * \retval false
+ *      Invalid index or count, the window is empty.
+ */
+bool DHT22MovingAverage::restore(int16_t *samples, uint8_t numSamples, uint8_t index,
+                                 uint8_t count)
+{
+    begin(samples, numSamples);
+
+    if ((_size == 0) || (index >= _size) || (count > _size)) {
+        return false;
+    }
+
+    _index = index;
+    _count = count;
+    for (uint8_t i = 0; i < _count; i++) {
+        _sum += _samples[i];
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Add sample and calculate the average in constant time.
+ * \param sample
+ *      New sample.
+ * \return
+ *      Average of the samples in the window, or the sample when average calculation is disabled.
+ */
+int16_t DHT22MovingAverage::add(int16_t sample)
+{
+    if (_size == 0) {
+        return sample;
+    }
+
+    if (_count < _size) {
+        // Window not full yet
+        _count++;
+    } else {
+        // Remove oldest sample from the sum
+        _sum -= _samples[_index];
+    }
+
+    // Store sample
+    _samples[_index] = sample;
+    _sum += sample;
+
+    if (++_index >= _size) {
+        _index = 0;
+    }
+
+    return (int16_t)(_sum / _count);
+}
+
+/*!
+ * \brief Calculate checksum of the window state and samples.
+ * \param checksum
+ *      Initial value.
+ * \return
+ *      Checksum.
+ */
+uint16_t DHT22MovingAverage::checksum(uint16_t checksum)
+{
+    checksum += ((uint16_t)_index << 8) | _count;
+
+    // Rotate before each addition, so swapped samples change the checksum
+    for (uint8_t i = 0; i < _count; i++) {
+        checksum = (uint16_t)((checksum << 1) | (checksum >> 15)) + (uint16_t)_samples[i];
+    }
+
+    return checksum;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private functions
+//--------------------------------------------------------------------------------------------------
+/*!
+ * \brief Copy configuration and last result of a sensor.
+ * \details
+ *      The conversion state, average samples, retained window, history and triggers belong to the
+ *      original and are not copied.
+ * \param other
+ *      Sensor to copy.
+ */
+void DHT22::copyFrom(const DHT22 &other)
+{
+    // Data pin and calibration
+    _pin = other._pin;
+    _inputRegister = other._inputRegister;
+    _bitMask = other._bitMask;
+    _maxCycles = other._maxCycles;
+    _bitThreshold = other._bitThreshold;
+
+    // Configuration
+    _numRetries = other._numRetries;
+    _retryBudget = other._retryBudget;
+    _backoff = other._backoff;
+    _captureMode = other._captureMode;
+
+    // Last result
+    memcpy(_data, other._data, sizeof(_data));
+    _status = other._status;
+    _temperature = other._temperature;
+    _humidity = other._humidity;
+    _numAttempts = other._numAttempts;
+    _numStartErrors = other._numStartErrors;
+    _lastMeasurementTimestamp = other._lastMeasurementTimestamp;
+    _stateTimestamp = other._stateTimestamp;
+#ifdef DHT22_STATS
+    _stats = other._stats;
+#endif
+
+#if DHT22_AUTO_SAMPLING
+    // Background sampling configuration and last successful conversion, no pending result
+    _autoInterval = other._autoInterval;
+    _validTimestamp = other._validTimestamp;
+    _valid = other._valid;
+    _newResult = false;
+    memset(&_newMeasurement, 0, sizeof(_newMeasurement));
+    _newTemperature = 0;
+    _newHumidity = 0;
+    _updating = false;
+#endif
+
+#if DHT22_POWER_CONTROL
+    // Power pin configuration and state, a discarded conversion is not in progress
+    _powerPin = other._powerPin;
+    _powered = other._powered;
+    _discardFirst = other._discardFirst;
+    _discarding = false;
+    _powerCycle = other._powerCycle;
+    _numFailures = other._numFailures;
+    _warmUpMs = other._warmUpMs;
+    _powerTimestamp = other._powerTimestamp;
+#endif
+
+    // Not shared with the original
+    _state = DHT22_STATE_IDLE;
+    _average = NULL;
+#if DHT22_HISTORY
+    _history = NULL;
+#endif
+#if DHT22_TRIGGERS
+    _triggers = NULL;
+#endif
+
+#if DHT22_SNAPSHOT
+    _sequence = 0;
+#endif
+    publishSnapshot();
+}
+
+/*!
+ * \brief Unregister all triggers, so they can be added to another sensor.
+ */
+void DHT22::releaseTriggers()
+{
+#if DHT22_TRIGGERS
+    while (_triggers != NULL) {
+        removeTrigger(_triggers);
+    }
+#endif
+}
+
+/*!
+ * \brief Disable average calculation and free the average allocated by begin().
+ */
+void DHT22::releaseAverage()
+{
+    if ((_average != NULL) && _average->allocated) {
+        free(_average);
+    }
+    _average = NULL;
+}
+
+/*!
+ * \brief Generate start condition: Data pin high for DHT22_START_HIGH_US, followed by low for
+ *        DHT22_START_LOW_US in poll().
+ * \details
+ *      The conversion is completed with DHT22_STATUS_BUS_ERROR when the idle data pin is low for
+ *      longer than the pulse timeout.
+ */
+void DHT22::startCondition()
+{
+    // Idle bus must be high, the data pin is an input with pull-up. Wait for the end of the last
+    // bit of a previous attempt.
+    if (waitPinChange(LOW) != true) {
+        DEBUG_PRINTLN(F("DHT22: Bus error"));
+        setStatus(DHT22_STATUS_BUS_ERROR);
+        finishConversion();
+        return;
+    }
+
+    // Data pin high (pull-up)
+    digitalWrite(_pin, HIGH);
+
+    _state = DHT22_STATE_START_HIGH;
+    _stateTimestamp = micros();
+}
+
+/*!
+ * \brief Abort a conversion in progress.
+ * \details
+ *      Releases the edge capture when this sensor owns the interrupt handler, so other sensors
+ *      can capture, and releases the data pin.
+ */
+void DHT22::abortConversion()
+{
+    if (_state == DHT22_STATE_IDLE) {
+        return;
+    }
+
+    if ((_state == DHT22_STATE_CAPTURE) && (_isrInstance == this)) {
+        stopEdgeCapture();
+    }
+
+    // Data pin to input (pull-up)
+    if (_state != DHT22_STATE_WARM_UP) {
+        pinMode(_pin, INPUT_PULLUP);
+    }
+
+    _state = DHT22_STATE_IDLE;
+}
+
+/*!
+ * \brief Complete conversion after the start condition.
+ * \details
+ *      Reads the sensor acknowledge, 5 Bytes data and checks the parity.
+ *      The result is stored with setStatus().
+ */
+void DHT22::completeConversion()
+{
+    if (_captureMode != DHT22_CAPTURE_POLLING) {
+        // Check sensor acknowledge
+        if (_numEdges == 0) {
+            DEBUG_PRINTLN(F("DHT22: Start error"));
+            setStatus(DHT22_STATUS_START_ERROR);
+            return;
+        }
+
+        // Decode the last 40 captured bits, preceded by at least the acknowledge
+        if ((_numBits <= DHT22_NUM_DATA_BITS) ||
+            (decodeBits((_numBits % DHT22_NUM_DATA_BITS) * 2) != true)) {
+            DEBUG_PRINTLN(F("DHT22: Read error"));
+            setStatus(DHT22_STATUS_TIMEOUT);
+            return;
+        }
+    } else {
+        // Release data pin and check sensor acknowledge
+        if (generateStart() != true) {
+            DEBUG_PRINTLN(F("DHT22: Start error"));
+            setStatus(DHT22_STATUS_START_ERROR);
+            return;
+        }
+
+        // Read 5 Bytes data from sensor
+        if (readBytes() != true) {
+            DEBUG_PRINTLN(F("DHT22: Read error"));
+            setStatus(DHT22_STATUS_TIMEOUT);
+            return;
+        }
+    }
+
+    // Check data parity
+    if (checkParity() != true) {
+        DEBUG_PRINTLN(F("DHT22: Parity error"));
+        setStatus(DHT22_STATUS_PARITY_ERROR);
+        return;
+    }
+
+    setStatus(DHT22_STATUS_OK);
+}
+
+/*!
+ * \brief Retry a failed conversion or complete the conversion.
+ * \details
+ *      A timeout or parity error is retried when the number of retries and the retry budget
+ *      allow another attempt. The retry is started by poll() DHT22_MIN_READ_INTERVAL after the
+ *      start of the previous attempt. A missing sensor is not retried.
+ * \retval true
+ *      Conversion completed.
+ * \retval false
+ *      Retry started.
+ */
+bool DHT22::finishConversion()
+{
+#if DHT22_POWER_CONTROL
+    if (_discarding) {
+        // Convert again after the first conversion after power-on
+        _discarding = false;
+        _state = DHT22_STATE_WARM_UP;
+        return false;
+    }
+#endif
+
+    // Retry n starts n * DHT22_MIN_READ_INTERVAL after the first attempt
+    if (((_status == DHT22_STATUS_TIMEOUT) || (_status == DHT22_STATUS_PARITY_ERROR)) &&
+        (_numAttempts <= _numRetries) &&
+        ((((uint32_t)_numAttempts * DHT22_MIN_READ_INTERVAL) + DHT22_CONVERSION_MAX_MS) <=
+         _retryBudget)) {
+        _numAttempts++;
+        _state = DHT22_STATE_RETRY;
+        return false;
+    }
+
+#if DHT22_POWER_CONTROL
+    // Power cycle the sensor after consecutive failed conversions
+    if (_status == DHT22_STATUS_OK) {
+        _numFailures = 0;
+    } else if ((_powerCycle != 0) && (++_numFailures >= _powerCycle)) {
+        DEBUG_PRINTLN(F("DHT22: Power cycle"));
+        _numFailures = 0;
+        powerOff();
+    }
+#endif
+
+    publishSnapshot();
+    _state = DHT22_STATE_IDLE;
+    return true;
+}
+
+/*!
+ * \brief Store conversion status, add samples, evaluate triggers and update statistics.
+ * \details
+ *      In background sampling mode, the history and triggers are processed by available().
+ * \param status
+ *      Conversion status DHT22_STATUS_OK, DHT22_STATUS_START_ERROR, DHT22_STATUS_TIMEOUT,
+ *      DHT22_STATUS_PARITY_ERROR or DHT22_STATUS_BUS_ERROR.
+ */
+void DHT22::setStatus(uint8_t status)
+{
+#if DHT22_POWER_CONTROL
+    if (_discarding) {
+        // First conversion after power-on is not used
+        return;
+    }
+#endif
+
+    _status = status;
+
+    // Count consecutive conversions without sensor acknowledge for the backoff
+    if ((status == DHT22_STATUS_START_ERROR) || (status == DHT22_STATUS_BUS_ERROR)) {
+        if (_numStartErrors < 0xFF) {
+            _numStartErrors++;
+        }
+    } else {
+        _numStartErrors = 0;
+    }
+
+    if (status == DHT22_STATUS_OK) {
+        int16_t temperature = decodeTemperature();
+        int16_t humidity = decodeHumidity();
+
+        // Add samples once per successful conversion
+        if (_average != NULL) {
+            _temperature = _average->temperature.add(temperature);
+            _humidity = _average->humidity.add(humidity);
+
+            if (_average->retained != NULL) {
+                // Store window state for the next wake-up
+                _average->retained->index = _average->temperature._index;
+                _average->retained->count = _average->temperature._count;
+                _average->retained->checksum = retainedChecksum();
+            }
+        } else {
+            _temperature = temperature;
+            _humidity = humidity;
+        }
+
+#if DHT22_AUTO_SAMPLING
+        _validTimestamp = _lastMeasurementTimestamp;
+        _valid = true;
+
+        if (_autoInterval != 0) {
+            // Background sampling: Processed by available() outside update()
+            _newMeasurement = getMeasurement();
+            _newTemperature = temperature;
+            _newHumidity = humidity;
+        } else
+#endif
+        {
+            notifyResult(getMeasurement(), temperature, humidity);
+        }
+    }
+
+#ifdef DHT22_STATS
+    switch (status) {
+        case DHT22_STATUS_OK:
+            _stats.numSuccess++;
+            break;
+        case DHT22_STATUS_START_ERROR:
+        case DHT22_STATUS_BUS_ERROR:
+            _stats.numStartErrors++;
+            break;
+        case DHT22_STATUS_TIMEOUT:
+            _stats.numTimeoutErrors++;
+            break;
+        default:
+            _stats.numParityErrors++;
+            break;
+    }
+#endif
+}
+
+/*!
+ * \brief Add a successful conversion to the history and evaluate triggers.
+ * \param measurement
+ *      Averaged result of the conversion.
+ * \param temperature
+ *      Unfiltered temperature with last digit after the point.
+ * \param humidity
+ *      Unfiltered humidity with last digit after the point.
+ */
+void DHT22::notifyResult(const DHT22Measurement &measurement, int16_t temperature,
+                         int16_t humidity)
+{
+#if DHT22_HISTORY
+    if (_history != NULL) {
+        _history->add(measurement.timestamp / 1000, temperature, humidity);
+    }
+#else
+    (void)temperature;
+    (void)humidity;
+#endif
+
+#if DHT22_TRIGGERS
+    // Evaluate triggers with the averaged values, a callback may remove its trigger
+    DHT22Trigger *trigger = _triggers;
+    while (trigger != NULL) {
+        DHT22Trigger *next = trigger->_next;
+
+        trigger->evaluate(this, (trigger->_source == DHT22_TRIGGER_HUMIDITY) ?
+                                measurement.humidity : measurement.temperature,
+                          measurement.timestamp);
+        trigger = next;
+    }
+#else
+    (void)measurement;
+#endif
+}
+
+/*!
+ * \brief Publish the result of a completed conversion for getSnapshot().
+ * \details
+ *      While the first buffer is written, the sequence counter is odd and readers use the second
+ *      buffer, and vice versa. A reader interrupting this function always finds a complete
+ *      buffer.
+ */
+void DHT22::publishSnapshot()
+{
+#if DHT22_SNAPSHOT
+    DHT22Measurement measurement = getMeasurement();
+
+    _sequence++;
+    DHT22_MEMORY_BARRIER();
+    _snapshots[0] = measurement;
+    DHT22_MEMORY_BARRIER();
+    _sequence++;
+    DHT22_MEMORY_BARRIER();
+    _snapshots[1] = measurement;
+#endif
+}
+
+/*!
+ * \brief Initialize sensor with a retained average window.
+ * \param average
+ *      Average state.
+ * \param header
+ *      Retained window state.
+ * \param temperatureSamples
+ *      Retained temperature samples.
+ * \param humiditySamples
+ *      Retained humidity samples.
+ * \param numSamples
+ *      Number of samples in the window.
+ * \retval true
+ *      Window restored.
+ * \retval false
+ *      Signature or checksum invalid, window cleared.
+ */
+bool DHT22::beginRetained(DHT22Average *average, DHT22RetainedHeader *header,
+                          int16_t *temperatureSamples, int16_t *humiditySamples, uint8_t numSamples)
+{
+    bool valid = false;
+
+    begin();
+
+    setAverage(average, temperatureSamples, humiditySamples, numSamples);
+    average->retained = header;
+
+    // Temperature and humidity samples are always added together, so they share index and count
+    if ((header->signature == DHT22_RETAINED_SIGNATURE) && (header->numSamples == numSamples) &&
+        average->temperature.restore(temperatureSamples, numSamples, header->index,
+                                     header->count) &&
+        average->humidity.restore(humiditySamples, numSamples, header->index, header->count)) {
+        valid = (retainedChecksum() == header->checksum);
+    }
+
+    if (!valid) {
+        // Power-on or corrupted memory: Start with an empty window
+        average->temperature.begin(temperatureSamples, numSamples);
+        average->humidity.begin(humiditySamples, numSamples);
+
+        header->signature = DHT22_RETAINED_SIGNATURE;
+        header->numSamples = numSamples;
+        header->index = 0;
+        header->count = 0;
+        header->checksum = retainedChecksum();
+    }
+
+    return valid;
+}
+
+/*!
+ * \brief Calculate checksum of the retained average window.
+ * \return
+ *      Checksum.
+ */
+uint16_t DHT22::retainedChecksum()
+{
+    uint16_t checksum = _average->retained->numSamples;
+
+    checksum = _average->temperature.checksum(checksum);
+    checksum = _average->humidity.checksum(checksum);
+
+    return checksum;
+}
+
+/*!
+ * \brief Decode temperature from the sensor data.
+ * \return
+ *      Signed temperature with last digit after the point.
+ */
+int16_t DHT22::decodeTemperature()
+{
+    int16_t temperature;
+
+    // Calculate signed temperature
+    temperature = ((_data[2] & 0x7F) << 8) | _data[3];
+    if (_data[2] & 0x80) {
+        temperature *= -1;
+    }
+
+    return temperature;
+}
+
+/*!
+ * \brief Decode humidity from the sensor data.
+ * \return
+ *      Humidity with last digit after the point.
+ */
+int16_t DHT22::decodeHumidity()
+{
+    return (int16_t)((_data[0] << 8) | _data[1]);
+}
+
+/*!
+ * \brief Check parity of the 5 data bytes.
+ * \retval true
+ *      Parity correct.
+ * \retval false
+ *      Parity error.
+ */
+bool DHT22::checkParity()
+{
+    return (((_data[0] + _data[1] + _data[2] + _data[3]) & 0xFF) == _data[4]);
+}
+
+/*!
+ * \brief Release data pin after the start condition and check sensor acknowledge.
+ * \details
+ *      The start condition (data pin high, followed by low) is generated by poll().
+ * \retval true
+ *      Success, continue with reading temperature and humidity bytes.
+ * \retval false
+ *      Failure, the sensor did not respond.
+ */
+bool DHT22::generateStart()
+{
+    // Data pin to input (pull-up)
+    pinMode(_pin, INPUT_PULLUP);
+
+    // Wait until the pull-up releases the data pin, followed by the sensor acknowledge low,
+    // instead of a fixed delay. Abort without acknowledge after the pulse timeout.
+    if ((waitPinChange(LOW) != true) || (waitPinChange(HIGH) != true)) {
+        return false;
+    }
+
+    // Check data pin timing low
+    if (measurePulseWidth(LOW) == 0) {
+        return false;
+    }
+
+    // Check data pin timing high
+    if (measurePulseWidth(HIGH) == 0) {
+        return false;
+    }
+
+    // Sensor start successfully generated
+    return true;
+}
+
+/*!
+ * \brief Wait until the data pin changes from a level.
+ * \param level
+ *      Current data pin level LOW or HIGH.
+ * \retval true
+ *      Data pin changed, or was not at this level.
+ * \retval false
+ *      Pulse timeout.
+ */
+bool DHT22::waitPinChange(uint8_t level)
+{
+    // measurePulseWidth() returns 0 on a timeout and when the pin is not at this level
+    return (measurePulseWidth(level) != 0) || (digitalRead(_pin) != level);
+}
+
+/*!
+ * \brief Read humidity, temperature and parity bytes from sensor.
+ * \details
+ *      Global interrupts are disabled during pin measurement, because the timing in micro seconds
+ *      is very critical.
+ *
+ *      Each bit is decoded directly after measuring the high pulse, while the sensor generates the
+ *      low pulse of the next bit. This requires no pulse width buffer.
+ * \retval true
+ *      Read bytes successful.
+ * \retval false
+ *      Incorrect timing sensor data pin received.
+ */
+bool DHT22::readBytes()
+{
+    uint32_t lowCycles;
+    uint32_t highCycles;
+    bool status = true;
+#ifdef DHT22_STATS
+    uint32_t sumCycles = 0;
+#endif
+
+    // Clear data buffer
+    memset(_data, 0, sizeof(_data));
+
+    // Disable interrupts during data transfer
+    noInterrupts();
+
+    for (int i = 0; i < DHT22_NUM_DATA_BITS; ++i) {
+        // Measure pulse width of each bit
+        lowCycles = measurePulseWidth(LOW);
+        highCycles = measurePulseWidth(HIGH);
+
+#ifdef DHT22_STATS
+        sumCycles += lowCycles + highCycles;
+#endif
+
+        // Check valid bit timing
+        if ((lowCycles == 0) || (highCycles == 0)) {
+            status = false;
+            break;
+        }
+
+        // Store bit: Compare high pulse with the calibrated threshold, or with the low pulse when
+        // not calibrated
+        _data[i / 8] <<= 1;
+        if (highCycles > (_bitThreshold ? _bitThreshold : lowCycles)) {
+            _data[i / 8] |= 1;
+        }
+    }
+
+    // Enable interrupts
+    interrupts();
+
+#ifdef DHT22_STATS
+    // A timed out pulse is not included in the sum, add the timeout
+    if (status != true) {
+        sumCycles += _maxCycles;
+    }
+
+    _stats.captureLengthLast = cyclesToMicroseconds(sumCycles);
+    _stats.interruptsOffLast = _stats.captureLengthLast;
+    if ((_stats.interruptsOffMin == 0) || (_stats.interruptsOffLast < _stats.interruptsOffMin)) {
+        _stats.interruptsOffMin = _stats.interruptsOffLast;
+    }
+    if (_stats.interruptsOffLast > _stats.interruptsOffMax) {
+        _stats.interruptsOffMax = _stats.interruptsOffLast;
+    }
+#endif
+
+    return status;
+}
+
+/*!
+ * \brief Convert pulse widths to data bits.
+ * \param first
+ *      Index of the first bit low pulse width in the pulse width ring buffer.
+ * \retval true
+ *      Decode successful.
+ * \retval false
+ *      Incorrect timing sensor data pin received.
+ */
+bool DHT22::decodeBits(uint8_t first)
+{
+#ifdef DHT22_STATS
+    uint16_t captureLength = 0;
+#endif
+
+    // Clear data buffer
+    memset(_data, 0, sizeof(_data));
+
+    // Convert pulse width to data bit
+    for (int i = 0; i < DHT22_NUM_DATA_BITS; ++i) {
+        uint8_t lowWidth = _widths[(first + (2 * i)) % (DHT22_NUM_DATA_BITS * 2)];
+        uint8_t highWidth = _widths[(first + (2 * i) + 1) % (DHT22_NUM_DATA_BITS * 2)];
+
+#ifdef DHT22_STATS
+        captureLength += lowWidth + highWidth;
+        _stats.captureLengthLast = captureLength;
+#endif
+
+        // Check valid bit timing
+        if ((lowWidth == 0) || (highWidth == 0)) {
+            return false;
+        }
+
+        // Calculate byte index in data array
+        int byteIndex = i / 8;
+
+        // Store bit: Pulse widths are in micro seconds
+        _data[byteIndex] <<= 1;
+        if (highWidth > DHT22_BIT_THRESHOLD_US) {
+            _data[byteIndex] |= 1;
         }
     }
+
+    return true;
+}
+
+/*!
+ * \brief Release data pin and start interrupt or Timer1 input capture edge capture.
+ * \retval true
+ *      Capture started.
+ * \retval false
+ *      Edge capture is in use by another sensor.
+ */
+bool DHT22::startEdgeCapture()
+{
+    if (_isrInstance != NULL) {
+        return false;
+    }
+
+    _isrInstance = this;
+    _numBits = 0;
+
+    // Ignore edges until the data pin is released, such as a stale interrupt flag
+    _numEdges = 0xFF;
+
+#if defined(DHT22_ICP1_CAPTURE) && defined(DHT22_ICP1_PIN)
+    if (_captureMode == DHT22_CAPTURE_ICP1) {
+        noInterrupts();
+
+        // Save Timer1 configuration
+        timer1Tccr1a = TCCR1A;
+        timer1Tccr1b = TCCR1B;
+        timer1Timsk1 = TIMSK1;
+
+        // Normal mode, noise canceler, capture on falling edge (acknowledge), clock / 8
+        TCCR1A = 0;
+        TCCR1B = (1 << ICNC1) | (1 << CS11);
+        TIFR1 = (1 << ICF1);
+        TIMSK1 = (1 << ICIE1);
+
+        interrupts();
+    } else
+#endif
+    {
+        // Timestamp each edge
+        attachInterrupt(digitalPinToInterrupt(_pin), edgeISR, CHANGE);
+    }
+
+    // Data pin to input (pull-up) after the capture is started, so the acknowledge cannot be
+    // missed. The rising edge of the release is ignored, the acknowledge is the first falling
+    // edge.
+    pinMode(_pin, INPUT_PULLUP);
+    _numEdges = 0;
+
+    return true;
+}
+
+/*!
+ * \brief Stop interrupt or Timer1 input capture edge capture.
+ */
+void DHT22::stopEdgeCapture()
+{
+#if defined(DHT22_ICP1_CAPTURE) && defined(DHT22_ICP1_PIN)
+    if (_captureMode == DHT22_CAPTURE_ICP1) {
+        noInterrupts();
+
+        // Restore Timer1 configuration
+        TIMSK1 = timer1Timsk1;
+        TCCR1A = timer1Tccr1a;
+        TCCR1B = timer1Tccr1b;
+        TIFR1 = (1 << ICF1);
+
+        interrupts();
+    } else
+#endif
+    {
+        detachInterrupt(digitalPinToInterrupt(_pin));
+    }
+
+    _isrInstance = NULL;
+}
+
+/*!
+ * \brief Pin change interrupt handler.
+ * \details
+ *      Timestamps each edge in micro seconds.
+ */
+void DHT22_ISR_ATTR DHT22::edgeISR()
+{
+    unsigned long timestamp = micros();
+
+    if (_isrInstance == NULL) {
+        return;
+    }
+
+    storeEdge(timestamp - _lastEdgeTimestamp, (digitalRead(_isrInstance->_pin) == LOW));
+
+    _lastEdgeTimestamp = timestamp;
+}
+
+/*!
+ * \brief Timer1 input capture interrupt handler.
+ * \details
+ *      Called from the TIMER1_CAPT_vect interrupt when DHT22_ICP1_CAPTURE is enabled. Timer1 runs
+ *      at clock / 8, so the captured timestamps are converted to micro seconds.
+ */
+void DHT22::icp1ISR()
+{
+#if defined(DHT22_ICP1_CAPTURE) && defined(DHT22_ICP1_PIN)
+    uint16_t timestamp = ICR1;
+    bool falling = ((TCCR1B & (1 << ICES1)) == 0);
+
+    // Capture next edge on the opposite level
+    TCCR1B ^= (1 << ICES1);
+    TIFR1 = (1 << ICF1);
+
+    if (_isrInstance == NULL) {
+        return;
+    }
+
+    storeEdge(((uint32_t)(uint16_t)(timestamp - (uint16_t)_lastEdgeTimestamp) * 8) /
+              clockCyclesPerMicrosecond(), falling);
+
+    _lastEdgeTimestamp = timestamp;
 #endif
+}
+
+/*!
+ * \brief Store a captured edge.
+ * \details
+ *      The first edge must be the falling edge of the sensor acknowledge, earlier rising edges
+ *      are ignored. A falling edge completes a bit, which stores the low and high pulse width pair
+ *      in the pulse width ring buffer. Leading pairs, such as the acknowledge, are overwritten by
+ *      the data bits. Pulse widths are saturated at 255 us.
+ * \param width
+ *      Time between the previous and this edge in micro seconds, ignored for the first edge.
+ * \param falling
+ *      true: Falling edge, false: Rising edge.
+ */
+void DHT22_ISR_ATTR DHT22::storeEdge(unsigned long width, bool falling)
+{
+    uint8_t index;
+
+    if ((_numEdges == 0xFF) || ((_numEdges == 0) && !falling)) {
+        return;
+    }
+
+    if (_numEdges) {
+        if (width > 0xFF) {
+            width = 0xFF;
+        }
+
+        if (falling) {
+            // Falling edge: End of high pulse, store bit
+            index = (_numBits % DHT22_NUM_DATA_BITS) * 2;
+            _widths[index] = _lowWidth;
+            _widths[index + 1] = (uint8_t)width;
+            _numBits++;
+        } else {
+            // Rising edge: End of low pulse
+            _lowWidth = (uint8_t)width;
+        }
+    }
+
+    _numEdges++;
+}
+
+/*!
+ * \brief Measure data pin pulse width.
+ * \details
+ *      The GPIO input register is read directly when supported by the target. This reduces the
+ *      loop time and makes it independent of the digitalRead() implementation of the core.
+ *      DHT22Pin overrides this function with a compile-time pin read.
+ * \param level Measure data signal low or high.
+ * \retval Pin timing
+ *      Sensor data pin timing in us.
+ * \retal 0
+ *      Timeout
+ */
+uint32_t DHT22::measurePulseWidth(uint8_t level)
+{
+    uint32_t count = 0;
+
+    if (DHT22GpioTraits::fastRead && (_inputRegister != NULL)) {
+        const volatile DHT22GpioTraits::reg_t *inputRegister = _inputRegister;
+        DHT22GpioTraits::reg_t bitMask = _bitMask;
+        DHT22GpioTraits::reg_t state = level ? bitMask : (DHT22GpioTraits::reg_t)0;
+
+        while ((*inputRegister & bitMask) == state) {
+            if (count++ >= _maxCycles) {
+                // Timeout
+                return 0;
+            }
+        }
+    } else {
+        while (digitalRead(_pin) == level) {
+            if (count++ >= _maxCycles) {
+                // Timeout
+                return 0;
+            }
+        }
+    }
 
     return count;
 }
+
+#ifdef DHT22_STATS
+/*!
+ * \brief Convert measurePulseWidth() loop iterations to micro seconds.
+ * \param cycles
+ *      Number of loop iterations.
+ * \return
+ *      Estimated duration in micro seconds, saturated at 65535.
+ */
+uint16_t DHT22::cyclesToMicroseconds(uint32_t cycles)
+{
+    // _maxCycles is the pulse timeout when calibrated, or 1 ms CPU clock cycles when not
+    uint32_t timeoutUs = _bitThreshold ? DHT22_PULSE_TIMEOUT_US : 1000;
+    uint32_t us;
+
+    if (_maxCycles == 0) {
+        return 0;
+    }
+
+    us = (uint32_t)(((uint64_t)cycles * timeoutUs) / _maxCycles);
+
+    return (us > 0xFFFF) ? 0xFFFF : (uint16_t)us;
+}
+#endif
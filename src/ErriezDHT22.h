@@ -34,10 +34,43 @@
 #define ERRIEZ_DHT22_H_
 
 #include <Arduino.h>
+#include "ErriezDHT22Gpio.h"
+#include "ErriezDHT22History.h"
+#include "ErriezDHT22Trigger.h"
 
 //! Enable debug prints to Serial
 // #define DEBUG_PRINT
 
+//! Enable Timer1 input capture (ICP1) on AVR targets. This defines the TIMER1_CAPT_vect interrupt
+//! handler, so it cannot be combined with other libraries using this interrupt.
+// #define DHT22_ICP1_CAPTURE
+
+//! Enable error and timing statistics, see DHT22::getStats()
+// #define DHT22_STATS
+
+//! Optional features with RAM per sensor object on AVR targets, enabled by default. Set to 0 here
+//! or with a compiler flag, such as -DDHT22_SNAPSHOT=0, to save RAM. See DHT22 for the footprint.
+//! Background sampling with setAutoSampling(), update() and getAge(): 25 Bytes
+#ifndef DHT22_AUTO_SAMPLING
+  #define DHT22_AUTO_SAMPLING       1
+#endif
+//! Sensor power pin with setPowerPin(), setFirstReadPolicy() and setPowerCycle(): 12 Bytes
+#ifndef DHT22_POWER_CONTROL
+  #define DHT22_POWER_CONTROL       1
+#endif
+//! Lock-free result with getSnapshot(): 21 Bytes
+#ifndef DHT22_SNAPSHOT
+  #define DHT22_SNAPSHOT            1
+#endif
+//! History with setHistory(): 2 Bytes
+#ifndef DHT22_HISTORY
+  #define DHT22_HISTORY             1
+#endif
+//! Triggers with addTrigger(): 2 Bytes
+#ifndef DHT22_TRIGGERS
+  #define DHT22_TRIGGERS            1
+#endif
+
 //! Minimum interval between sensor reads in milli seconds
 #define DHT22_MIN_READ_INTERVAL     2000
 
@@ -49,6 +82,120 @@
 //!   1 Byte: Parity
 #define DHT22_NUM_DATA_BITS         (5 * 8)
 
+//! Pulse timeout in micro seconds (Longest valid pulse is the 80 us acknowledge)
+#define DHT22_PULSE_TIMEOUT_US      200
+//! High pulse width threshold in micro seconds between a 0 bit (26..28 us) and 1 bit (70 us)
+#define DHT22_BIT_THRESHOLD_US      48
+//! Minimum duration of the loop time calibration in micro seconds
+#define DHT22_CALIBRATION_US        1000
+
+//! Start condition: Data pin high duration in micro seconds
+#define DHT22_START_HIGH_US         10000
+//! Start condition: Data pin low duration in micro seconds
+#define DHT22_START_LOW_US          20000
+
+//! Maximum duration of one conversion attempt in milli seconds: Start condition and capture timeout
+#define DHT22_CONVERSION_MAX_MS     ((DHT22_START_HIGH_US + DHT22_START_LOW_US + \
+                                      DHT22_CAPTURE_TIMEOUT_US) / 1000)
+//! Default number of retries after a read error
+#define DHT22_DEFAULT_RETRIES       2
+//! Default retry budget in milli seconds: The default retries, each DHT22_MIN_READ_INTERVAL after
+//! the previous attempt
+#define DHT22_DEFAULT_RETRY_BUDGET  ((DHT22_DEFAULT_RETRIES * DHT22_MIN_READ_INTERVAL) + \
+                                     DHT22_CONVERSION_MAX_MS)
+
+//! Conversion status: Successful
+#define DHT22_STATUS_OK             0
+//! Conversion status: No sensor acknowledge after the start condition
+#define DHT22_STATUS_START_ERROR    1
+//! Conversion status: Data bit timeout or incomplete capture
+#define DHT22_STATUS_TIMEOUT        2
+//! Conversion status: Parity error
+#define DHT22_STATUS_PARITY_ERROR   3
+//! Conversion status: Data pin low before the start condition (short circuit or missing pull-up)
+#define DHT22_STATUS_BUS_ERROR      4
+
+//! Maximum backoff of a sensor without acknowledge: DHT22_MIN_READ_INTERVAL << 5 = 64 seconds
+#define DHT22_BACKOFF_MAX_SHIFT     5
+
+//! getAge() return value when no conversion was successful
+#define DHT22_AGE_INVALID           0xFFFFFFFFUL
+
+//! No sensor power pin
+#define DHT22_POWER_PIN_NONE        0xFF
+//! Default sensor warm-up time after power-on in milli seconds
+#define DHT22_POWER_WARM_UP_MS      2000
+//! Minimum sensor power-off time of a power cycle in milli seconds
+#define DHT22_POWER_OFF_MS          1000
+
+//! First conversion after power-on: Keep the result (default)
+#define DHT22_FIRST_READ_KEEP       0
+//! First conversion after power-on: Discard the result and convert again after
+//! DHT22_MIN_READ_INTERVAL
+#define DHT22_FIRST_READ_DISCARD    1
+
+//! Signature of a valid DHT22Retained average window ("DHT2")
+#define DHT22_RETAINED_SIGNATURE    0x44485432UL
+
+//! Conversion state: No conversion in progress
+#define DHT22_STATE_IDLE            0
+//! Conversion state: Start condition, data pin high
+#define DHT22_STATE_START_HIGH      1
+//! Conversion state: Start condition, data pin low
+#define DHT22_STATE_START_LOW       2
+//! Conversion state: Interrupt edge capture in progress
+#define DHT22_STATE_CAPTURE         3
+//! Conversion state: Sensor power-off, power-on and warm-up before the start condition
+#define DHT22_STATE_WARM_UP         4
+//! Conversion state: Wait DHT22_MIN_READ_INTERVAL between a failed attempt and the retry
+#define DHT22_STATE_RETRY           5
+
+//! Capture mode: Busy-wait pulse width measurement with interrupts disabled (default)
+#define DHT22_CAPTURE_POLLING       0
+//! Capture mode: Pin change interrupt timestamps each edge, interrupts stay enabled
+#define DHT22_CAPTURE_INTERRUPT     1
+//! Capture mode: Timer1 input capture timestamps each edge in hardware (AVR ICP1 pin only)
+#define DHT22_CAPTURE_ICP1          2
+
+//! Arduino pin number of the Timer1 input capture pin ICP1
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega328PB__) || \
+    defined(__AVR_ATmega168__) || defined(__AVR_ATmega168P__) || defined(__AVR_ATmega88__)
+  #define DHT22_ICP1_PIN            8
+#elif defined(__AVR_ATmega32U4__)
+  #define DHT22_ICP1_PIN            4
+#endif
+
+//! Number of data pin edges in a frame: Acknowledge low and high, 40 bits low and high, end of
+//! last bit and release of the data pin
+#define DHT22_NUM_EDGES             (2 + (DHT22_NUM_DATA_BITS * 2) + 2)
+//! Interrupt edge capture timeout in micro seconds (A frame takes ~5 ms)
+#define DHT22_CAPTURE_TIMEOUT_US    10000
+
+//! Interrupt service routine attribute
+#if defined(ESP8266) || defined(ESP32)
+  #define DHT22_ISR_ATTR            IRAM_ATTR
+#else
+  #define DHT22_ISR_ATTR
+#endif
+
+//! Memory section attribute for a DHT22Retained object which survives deep sleep and resets:
+//!   ESP32: RTC slow memory, retained in deep sleep
+//!   AVR:   .noinit section, not cleared after a watchdog or external reset
+#if defined(ESP32)
+  #define DHT22_RETAINED_ATTR       RTC_DATA_ATTR
+#elif defined(__AVR)
+  #define DHT22_RETAINED_ATTR       __attribute__((section(".noinit")))
+#else
+  #define DHT22_RETAINED_ATTR
+#endif
+
+//! Memory barrier between the snapshot sequence counter and snapshot data accesses
+#ifdef __AVR
+  #define DHT22_MEMORY_BARRIER()    __asm__ __volatile__("" ::: "memory")
+#else
+  #define DHT22_MEMORY_BARRIER()    __sync_synchronize()
+#endif
+
 //! Debug print configuration
 #ifdef DEBUG_PRINT
   #define DEBUG_PRINTLN(...) { Serial.println(__VA_ARGS__); }
@@ -56,6 +203,141 @@
   #define DEBUG_PRINTLN(...) {}
 #endif
 
+/*!
+ * \brief Conversion error and timing statistics
+ * \details
+ *      Only collected when DHT22_STATS is defined. Durations are in micro seconds. The
+ *      interrupts-off duration of the polling capture is estimated from the calibrated pulse width
+ *      loop, because micros() does not run with interrupts disabled on all targets.
+ */
+typedef struct {
+    //! Number of successful conversions
+    uint32_t numSuccess;
+    //! Number of conversions without sensor acknowledge or with the data pin low (bus error)
+    uint32_t numStartErrors;
+    //! Number of conversions with a data bit timeout or incomplete capture
+    uint32_t numTimeoutErrors;
+    //! Number of conversions with a parity error
+    uint32_t numParityErrors;
+    //! Minimum interrupts-off duration of the polling capture, 0 when not measured
+    uint16_t interruptsOffMin;
+    //! Maximum interrupts-off duration of the polling capture
+    uint16_t interruptsOffMax;
+    //! Last interrupts-off duration of the polling capture
+    uint16_t interruptsOffLast;
+    //! Duration of the captured data bits of the last conversion
+    uint16_t captureLengthLast;
+} DHT22Stats;
+
+/*!
+ * \brief Result of a conversion
+ * \details
+ *      Temperature and humidity are only valid when the status is DHT22_STATUS_OK, so the ~0 error
+ *      value of readTemperature() is not needed and -0.1 degree Celsius can be distinguished from
+ *      an error.
+ */
+typedef struct {
+    //! Signed temperature with last digit after the point, averaged when enabled
+    int16_t temperature;
+    //! Humidity with last digit after the point, averaged when enabled
+    int16_t humidity;
+    //! millis() timestamp of the start of the conversion
+    uint32_t timestamp;
+    //! Conversion status DHT22_STATUS_OK, DHT22_STATUS_START_ERROR, DHT22_STATUS_TIMEOUT,
+    //! DHT22_STATUS_PARITY_ERROR or DHT22_STATUS_BUS_ERROR
+    uint8_t status;
+    //! Number of read attempts, 0 when no conversion has been performed or skipped by the backoff
+    uint8_t attempts;
+} DHT22Measurement;
+
+/*!
+ * \brief Moving average filter with a running sum
+ * \details
+ *      The sum of the samples in the window is updated incrementally by subtracting the evicted
+ *      sample, so adding a sample and calculating the average takes constant time. The 32-bit sum
+ *      cannot overflow for windows up to 255 samples.
+ */
+class DHT22MovingAverage
+{
+    friend class DHT22;
+
+public:
+    void begin(int16_t *samples, uint8_t numSamples);
+    bool restore(int16_t *samples, uint8_t numSamples, uint8_t index, uint8_t count);
+    int16_t add(int16_t sample);
+    uint16_t checksum(uint16_t checksum);
+
+private:
+    //! Sample buffer, NULL when average calculation is disabled
+    int16_t *_samples;
+    //! Size of the sample buffer
+    uint8_t _size;
+    //! Index in the sample buffer for the next sample
+    uint8_t _index;
+    //! Number of samples in the sample buffer
+    uint8_t _count;
+    //! Sum of all samples in the sample buffer
+    int32_t _sum;
+};
+
+/*!
+ * \brief State of a retained average window, see DHT22Retained
+ */
+typedef struct {
+    //! DHT22_RETAINED_SIGNATURE when initialized
+    uint32_t signature;
+    //! Checksum of the window state and samples
+    uint16_t checksum;
+    //! Number of samples in the window
+    uint8_t numSamples;
+    //! Index in the sample buffers for the next sample
+    uint8_t index;
+    //! Number of samples in the sample buffers
+    uint8_t count;
+} DHT22RetainedHeader;
+
+/*!
+ * \brief Temperature and humidity average of a sensor
+ * \details
+ *      Stored in DHT22T, in DHT22Retained or on the heap by DHT22::begin(numSamples). A sensor
+ *      without average calculation only has a NULL pointer to it.
+ */
+typedef struct {
+    //! Temperature average
+    DHT22MovingAverage temperature;
+    //! Humidity average
+    DHT22MovingAverage humidity;
+    //! State of the retained average window, NULL when not retained
+    DHT22RetainedHeader *retained;
+    //! Allocated by DHT22::begin(numSamples), freed by the sensor
+    bool allocated;
+} DHT22Average;
+
+/*!
+ * \brief Temperature and humidity average window in memory which is retained in deep sleep
+ * \details
+ *      Place the object in retained memory with DHT22_RETAINED_ATTR and pass it to
+ *      DHT22::begin(). The window is restored when the signature and checksum are valid, so the
+ *      average is correct with the first conversion after a wake-up.
+ *
+ *      On ESP8266, RTC memory is not memory mapped: Copy the object with ESP.rtcUserMemoryWrite()
+ *      before deep sleep and ESP.rtcUserMemoryRead() before begin().
+ * \tparam WindowSize
+ *      Number of samples to calculate temperature and humidity average.
+ */
+template <uint8_t WindowSize>
+struct DHT22Retained
+{
+    //! Window state
+    DHT22RetainedHeader header;
+    //! Average state, restored from the window state by DHT22::begin()
+    DHT22Average average;
+    //! Temperature samples
+    int16_t temperatureSamples[WindowSize];
+    //! Humidity samples
+    int16_t humiditySamples[WindowSize];
+};
+
 /*!
  * \brief DHT22 sensor class
  * \details
@@ -68,10 +350,46 @@
  *      The temperature/humidity read interval in this library is cached for 2 seconds to prevent
  *      heating-up the internal chip with continues reading.
  *
+ *      A conversion can be performed non-blocking with startConversion() and poll(). The start
+ *      condition is timed without delay() calls, so the application can continue during the
+ *      host-low phase. readSensorData() is a blocking wrapper around these functions.
+ *
+ *      A conversion with a timeout or parity error is restarted by poll() up to the configured
+ *      number of retries, as long as the next attempt fits in the retry budget. Attempts are
+ *      DHT22_MIN_READ_INTERVAL apart, because the sensor needs this time between reads. A missing
+ *      sensor acknowledge is not retried. See setRetries(). Conversions of a sensor without
+ *      acknowledge are skipped with an exponential backoff, see setBackoff().
+ *
+ *      With setAutoSampling(), conversions are started and completed in the background by
+ *      update(), called from loop(), yield() or a periodic timer interrupt. available() reports
+ *      each new result and readTemperature() / readHumidity() return the last successful value
+ *      with its age from getAge(). getSnapshot() reads a consistent result without locking from
+ *      an interrupt or another task.
+ *
+ *      The sensor can be powered from a digital pin with setPowerPin(). A conversion powers the
+ *      sensor on and waits for the warm-up time without blocking poll(). See
+ *      setFirstReadPolicy() and setPowerCycle().
+ *
  *      Global interrupts are disabled during a synchronous sensor read transfer. This is required
  *      to sample the data bit lengths at maximum speed on low-end devices without any application
  *      interrupts. The read calls are protected with a timeout.
  *
+ *      Alternatively, setCaptureMode(DHT22_CAPTURE_INTERRUPT) timestamps each data pin edge in a
+ *      pin change interrupt. Global interrupts stay enabled and poll() returns immediately during
+ *      the transfer. The data pin must support attachInterrupt() and only one sensor can capture
+ *      at a time.
+ *
+ *      On AVR targets with DHT22_ICP1_CAPTURE enabled, setCaptureMode(DHT22_CAPTURE_ICP1)
+ *      timestamps each edge with the Timer1 input capture unit when the data pin is connected to
+ *      ICP1 (Arduino UNO pin 8). Timer1 is reconfigured during the transfer and restored
+ *      afterwards.
+ *
+ *      RAM usage on AVR targets: sizeof(DHT22) is 104 Bytes with all optional features and
+ *      42 Bytes with DHT22_AUTO_SAMPLING, DHT22_POWER_CONTROL, DHT22_SNAPSHOT, DHT22_HISTORY and
+ *      DHT22_TRIGGERS set to 0, excluding the average samples and DHT22_STATS. The polling capture
+ *      decodes each bit on the fly. The interrupt capture uses an 80 Bytes pulse width buffer,
+ *      shared by all instances.
+ *
  *      The application is responsible for checking ~0 values after a read which means that the
  *      read failed or a timeout occurred. Multiple reads by the application with an average
  *      calculation is recommended.
@@ -79,59 +397,345 @@
  */
 class DHT22
 {
+    friend class DHT22Array;
+    friend class DHT22Scheduler;
+    //! Host tests, see test/
+    friend class DHT22TestAccess;
+
 public:
     explicit DHT22(uint8_t pin);
+    DHT22(const DHT22 &other);
+    virtual ~DHT22();
+    DHT22 &operator=(const DHT22 &other);
     void begin(uint8_t numSamples=0);
+
+    /*!
+     * \brief Initialize sensor with an average window in retained memory.
+     * \param retained
+     *      Average window, placed in memory with DHT22_RETAINED_ATTR.
+     * \retval true
+     *      Average window restored.
+     * \retval false
+     *      Average window invalid and cleared, for example after power-on.
+     */
+    template <uint8_t WindowSize>
+    bool begin(DHT22Retained<WindowSize> *retained)
+    {
+        return beginRetained(&retained->average, &retained->header, retained->temperatureSamples,
+                             retained->humiditySamples, WindowSize);
+    }
+
     bool available();
     bool readSensorData();
+    void startConversion();
+    bool poll();
+    bool isReady();
+    bool setCaptureMode(uint8_t captureMode);
+    bool calibrate();
+    void setRetries(uint8_t numRetries, uint16_t budgetMs=DHT22_DEFAULT_RETRY_BUDGET);
+    void setBackoff(bool enable);
+#if DHT22_AUTO_SAMPLING
+    void setAutoSampling(uint32_t intervalMs);
+    bool update();
+    uint32_t getAge();
+#endif
+#if DHT22_POWER_CONTROL
+    void setPowerPin(uint8_t powerPin, uint16_t warmUpMs=DHT22_POWER_WARM_UP_MS);
+    void setFirstReadPolicy(uint8_t policy);
+    void setPowerCycle(uint8_t numFailures);
+    void powerOn();
+    void powerOff();
+#endif
+    uint8_t getNumRetriesLastConversion();
+    bool getStats(DHT22Stats *stats);
+    void resetStats();
+
+    static void icp1ISR();
     int16_t readTemperature();
     int16_t readHumidity();
+    DHT22Measurement read();
+    DHT22Measurement getMeasurement();
+    DHT22Measurement getSnapshot();
+#if DHT22_HISTORY
+    void setHistory(DHT22History *history);
+#endif
+#if DHT22_TRIGGERS
+    bool addTrigger(DHT22Trigger *trigger);
+    void removeTrigger(DHT22Trigger *trigger);
+#endif
+
+protected:
+    //! Pulse timeout in measurePulseWidth() loop iterations
+    uint32_t _maxCycles;
+
+    void setAverage(DHT22Average *average, int16_t *temperatureSamples, int16_t *humiditySamples,
+                    uint8_t numSamples);
+    virtual uint32_t measurePulseWidth(uint8_t level);
 
 private:
     //! Timestamp of the last completed measurement
     unsigned long _lastMeasurementTimestamp;
-    //! Number of clock cycles per micro second for accurate pin measurement
-    uint32_t _maxCycles;
-    //! Buffer to store pin sample timing
-    //! To prevent stack overflows at run-time, allocate this 320 Bytes buffer
-    //! here instead of the function
-    uint32_t cycles[DHT22_NUM_DATA_BITS * 2];
+    //! High pulse width threshold in measurePulseWidth() loop iterations, 0 when not calibrated
+    uint32_t _bitThreshold;
     //! 5 raw sensor data bytes
     //! Humidity high, humidity low, temperature high, temperature low, parity
     uint8_t _data[5];
-    //! Last conversion status (Successful or not)
-    bool _statusLastMeasurement;
-
-    //! Number of samples for temperature and humidity caluculation
-    uint8_t _numSamples;
-
-    //! Temperature samples, allocated with malloc
-    int16_t *_temperatureSamples;
-    //! Temperature index in the samples buffer
-    uint8_t _temperatureSampleIndex;
-    //! Number of temperature samples
-    uint8_t _numTemperatureSamples;
-
-    //! Humidity samples, allocated with malloc
-    int16_t *_humiditySamples;
-    //! Humidity index in the samples buffer
-    uint8_t _humiditySampleIndex;
-    //! Number of humidity samples
-    uint8_t _numHumiditySamples;
+    //! Last conversion status DHT22_STATUS_OK, DHT22_STATUS_START_ERROR, DHT22_STATUS_TIMEOUT or
+    //! DHT22_STATUS_PARITY_ERROR
+    uint8_t _status;
+    //! Temperature of the last successful conversion, averaged when enabled
+    int16_t _temperature;
+    //! Humidity of the last successful conversion, averaged when enabled
+    int16_t _humidity;
+    //! Number of read attempts of the last conversion
+    uint8_t _numAttempts;
+    //! Maximum number of retries after a read error
+    uint8_t _numRetries;
+    //! Number of consecutive conversions without sensor acknowledge
+    uint8_t _numStartErrors;
+    //! Skip conversions of a sensor without acknowledge with exponential backoff
+    bool _backoff;
+    //! Retry budget in milli seconds since the start of the first attempt
+    uint16_t _retryBudget;
+    //! Conversion state
+    uint8_t _state;
+    //! Timestamp in micro seconds when the conversion state was entered
+    unsigned long _stateTimestamp;
+    //! Capture mode DHT22_CAPTURE_POLLING, DHT22_CAPTURE_INTERRUPT or DHT22_CAPTURE_ICP1
+    uint8_t _captureMode;
+#if DHT22_AUTO_SAMPLING
+    //! Background sampling interval in milli seconds, 0 when disabled
+    uint32_t _autoInterval;
+    //! Timestamp of the last successful conversion
+    unsigned long _validTimestamp;
+    //! A successful conversion is available
+    bool _valid;
+    //! New successful background conversion, cleared by available()
+    volatile bool _newResult;
+    //! Averaged result of the new background conversion for the triggers
+    DHT22Measurement _newMeasurement;
+    //! Unfiltered temperature of the new background conversion for the history
+    int16_t _newTemperature;
+    //! Unfiltered humidity of the new background conversion for the history
+    int16_t _newHumidity;
+    //! update() in progress, prevents re-entrance from yield() or a timer interrupt
+    volatile bool _updating;
+#endif
+#if DHT22_POWER_CONTROL
+    //! Sensor power pin, DHT22_POWER_PIN_NONE when not used
+    uint8_t _powerPin;
+    //! Sensor power is on
+    bool _powered;
+    //! Discard the first conversion after power-on
+    bool _discardFirst;
+    //! Current conversion is discarded
+    bool _discarding;
+    //! Number of consecutive failed conversions before a power cycle, 0 when disabled
+    uint8_t _powerCycle;
+    //! Number of consecutive failed conversions
+    uint8_t _numFailures;
+    //! Sensor warm-up time after power-on in milli seconds
+    uint16_t _warmUpMs;
+    //! Timestamp of the last power-on or power-off
+    unsigned long _powerTimestamp;
+#endif
+#if DHT22_SNAPSHOT
+    //! Snapshot sequence counter, odd while the first snapshot buffer is written
+    volatile uint8_t _sequence;
+    //! Double-buffered result of the last completed conversion, see getSnapshot()
+    DHT22Measurement _snapshots[2];
+#endif
+
+    //! Sensor which owns the pin change interrupt handler
+    static DHT22 *_isrInstance;
+    //! Ring buffer with low and high pulse widths in micro seconds (saturated at 255), shared by
+    //! all sensors, because only one sensor can capture at a time
+    static uint8_t _widths[DHT22_NUM_DATA_BITS * 2];
+    //! Number of captured edges by the interrupt handler
+    static volatile uint8_t _numEdges;
+    //! Number of bits (low and high pulse width pairs) stored by the interrupt handler
+    static volatile uint8_t _numBits;
+    //! Last low pulse width in micro seconds captured by the interrupt handler
+    static volatile uint8_t _lowWidth;
+    //! Timestamp in micro seconds or Timer1 ticks of the last captured edge
+    static volatile unsigned long _lastEdgeTimestamp;
+
+    //! Temperature and humidity average, NULL when average calculation is disabled
+    DHT22Average *_average;
+#if DHT22_HISTORY
+    //! History of successful conversions, NULL when disabled
+    DHT22History *_history;
+#endif
+#if DHT22_TRIGGERS
+    //! First trigger in the list, NULL when no triggers registered
+    DHT22Trigger *_triggers;
+#endif
+
+#ifdef DHT22_STATS
+    //! Error and timing statistics
+    DHT22Stats _stats;
+#endif
 
     //! Sensor data pin
     uint8_t _pin;
 
-#ifdef __AVR
-    //! Bit number in IO pin register
-    uint8_t _bit;
-    //! Port in IO pin register
-    uint8_t _port;
-#endif
+    //! GPIO input register of the data pin, NULL when digitalRead() is used
+    const volatile DHT22GpioTraits::reg_t *_inputRegister;
+    //! Bit mask of the data pin in the GPIO input register
+    DHT22GpioTraits::reg_t _bitMask;
 
+    void copyFrom(const DHT22 &other);
+    void releaseTriggers();
+    void releaseAverage();
+    void startCondition();
+    void abortConversion();
     bool generateStart();
+    bool waitPinChange(uint8_t level);
+    void completeConversion();
+    bool finishConversion();
+    void setStatus(uint8_t status);
+    void notifyResult(const DHT22Measurement &measurement, int16_t temperature,
+                      int16_t humidity);
+    void publishSnapshot();
+    bool beginRetained(DHT22Average *average, DHT22RetainedHeader *header,
+                       int16_t *temperatureSamples, int16_t *humiditySamples, uint8_t numSamples);
+    uint16_t retainedChecksum();
+    bool checkParity();
+    int16_t decodeTemperature();
+    int16_t decodeHumidity();
     bool readBytes();
-    uint32_t measurePulseWidth(uint8_t level);
+    bool startEdgeCapture();
+    void stopEdgeCapture();
+    bool decodeBits(uint8_t first);
+    static void edgeISR();
+    static void storeEdge(unsigned long width, bool falling);
+#ifdef DHT22_STATS
+    uint16_t cyclesToMicroseconds(uint32_t cycles);
+#endif
+};
+
+/*!
+ * \brief DHT22 sensor with temperature and humidity average samples stored in the object
+ * \details
+ *      The window size is a template parameter, so no heap is used. Call begin() without
+ *      arguments. DHT22T<0> has no average state and no sample storage: Average calculation is
+ *      disabled and costs only the NULL average pointer in DHT22.
+ * \tparam WindowSize
+ *      Number of samples to calculate temperature and humidity average.
+ */
+template <uint8_t WindowSize>
+class DHT22T : public DHT22
+{
+public:
+    /*!
+     * \brief Constructor DHT22 sensor.
+     * \param pin Data pin sensor.
+     */
+    explicit DHT22T(uint8_t pin) : DHT22(pin)
+    {
+    }
+
+    /*!
+     * \brief Initialize sensor and average calculation.
+     * \details
+     *      The sample buffers are bound here and not in the constructor, because a copy of the
+     *      object does not use the sample buffers of the original.
+     */
+    void begin()
+    {
+        DHT22::begin();
+        setAverage(&_window, _temperatureSamples, _humiditySamples, WindowSize);
+    }
+
+private:
+    //! Average state
+    DHT22Average _window;
+    //! Temperature samples
+    int16_t _temperatureSamples[WindowSize];
+    //! Humidity samples
+    int16_t _humiditySamples[WindowSize];
+};
+
+/*!
+ * \brief DHT22 sensor without average calculation
+ */
+template <>
+class DHT22T<0> : public DHT22
+{
+public:
+    /*!
+     * \brief Constructor DHT22 sensor.
+     * \param pin Data pin sensor.
+     */
+    explicit DHT22T(uint8_t pin) : DHT22(pin)
+    {
+    }
+
+    /*!
+     * \brief Initialize sensor without average calculation.
+     */
+    void begin()
+    {
+        DHT22::begin();
+    }
+};
+
+/*!
+ * \brief DHT22 sensor with the data pin selected at compile time
+ * \details
+ *      On ATmega328/168 targets, the GPIO input register and bit of the data pin are constants, so
+ *      the pulse width measurement loop reads the pin with a single instruction. This increases the
+ *      pulse width resolution and reduces the interrupts-off time. On other targets, this is
+ *      the same as DHT22T.
+ * \tparam Pin
+ *      Data pin sensor.
+ * \tparam WindowSize
+ *      Number of samples to calculate temperature and humidity average, 0 (default) to disable.
+ */
+template <uint8_t Pin, uint8_t WindowSize = 0>
+class DHT22Pin : public DHT22T<WindowSize>
+{
+public:
+    /*!
+     * \brief Constructor DHT22 sensor.
+     */
+    DHT22Pin() : DHT22T<WindowSize>(Pin)
+    {
+    }
+
+#ifdef DHT22_FAST_PIN
+protected:
+    /*!
+     * \brief Measure pulse width of the compile-time data pin.
+     * \param level Pulse level LOW or HIGH.
+     * \retval 0
+     *      Timeout.
+     * \retval >0
+     *      Number of loop iterations.
+     */
+    uint32_t measurePulseWidth(uint8_t level)
+    {
+        uint32_t count = 0;
+
+        if (level) {
+            while (DHT22FastPin<Pin>::read()) {
+                if (count++ >= this->_maxCycles) {
+                    // Timeout
+                    return 0;
+                }
+            }
+        } else {
+            while (!DHT22FastPin<Pin>::read()) {
+                if (count++ >= this->_maxCycles) {
+                    // Timeout
+                    return 0;
+                }
+            }
+        }
+
+        return count;
+    }
+#endif
 };
 
 #endif // ERRIEZ_DHT22_H_
@@ -0,0 +1,305 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDHT22Array.cpp
+ * \brief Read multiple DHT22 (AM2302/AM2303) sensors in one interleaved transfer
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#include "ErriezDHT22Array.h"
+
+/*!
+ * \brief Constructor DHT22 sensor array.
+ * \param sensors
+ *      Array with pointers to DHT22 sensor objects.
+ * \param numSensors
+ *      Number of sensors, maximum DHT22_ARRAY_MAX_SENSORS.
+ */
+DHT22Array::DHT22Array(DHT22 **sensors, uint8_t numSensors) :
+        _sensors(sensors), _numSensors(numSensors), _sharedPort(false)
+{
+    if (_numSensors > DHT22_ARRAY_MAX_SENSORS) {
+        _numSensors = DHT22_ARRAY_MAX_SENSORS;
+    }
+}
+
+/*!
+ * \brief Initialize sensor array.
+ * \details
+ *      Call this function from setup() after begin() of each sensor.
+ * \retval true
+ *      All data pins are on the same IO port: Sensors are read in one transfer.
+ * \retval false
+ *      Sensors are read one after another.
+ */
+bool DHT22Array::begin()
+{
+    _sharedPort = false;
+
+    // Initialize last measurement timestamp with negative interval to allow a new measurement
+    _lastMeasurementTimestamp = (uint32_t)-DHT22_MIN_READ_INTERVAL;
+
+    if (_numSensors == 0) {
+        return false;
+    }
+
+#ifdef DHT22_ARRAY_SHARED_PORT
+    // Check if all data pins are on the same IO port
+    _sharedPort = (_sensors[0]->_inputRegister != NULL);
+    for (uint8_t i = 1; i < _numSensors; i++) {
+        if (_sensors[i]->_inputRegister != _sensors[0]->_inputRegister) {
+            _sharedPort = false;
+        }
+    }
+
+#if DHT22_POWER_CONTROL
+    // The power-on, warm-up and power cycle of a sensor are handled by readSensorData()
+    for (uint8_t i = 0; i < _numSensors; i++) {
+        if (_sensors[i]->_powerPin != DHT22_POWER_PIN_NONE) {
+            _sharedPort = false;
+        }
+    }
+#endif
+#endif
+
+    return _sharedPort;
+}
+
+/*!
+ * \brief Check if a new read of all sensors is allowed and read sensors.
+ * \retval true
+ *      Interval between sensor reads >= 2000 ms and at least one sensor read was successful.
+ * \retval false
+ *      Interval between sensor reads too short, or all sensor reads failed.
+ */
+bool DHT22Array::available()
+{
+    if ((millis() - _lastMeasurementTimestamp) < DHT22_MIN_READ_INTERVAL) {
+        // Interval between sensor reads too short
+        return false;
+    }
+
+    return (readSensorData() != 0);
+}
+
+/*!
+ * \brief Read data from all sensors.
+ * \return
+ *      Bit mask of successful conversions. Bit 0 is the first sensor in the array.
+ */
+uint8_t DHT22Array::readSensorData()
+{
+    // Store last conversion timestamp
+    _lastMeasurementTimestamp = millis();
+
+#ifdef DHT22_ARRAY_SHARED_PORT
+    if (_sharedPort) {
+        return readSensorDataSharedPort();
+    }
+#endif
+
+    return readSensorDataSequential();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private functions
+//--------------------------------------------------------------------------------------------------
+/*!
+ * \brief Read sensors one after another.
+ * \return
+ *      Bit mask of successful conversions.
+ */
+uint8_t DHT22Array::readSensorDataSequential()
+{
+    uint8_t result = 0;
+
+    for (uint8_t i = 0; i < _numSensors; i++) {
+        if (_sensors[i]->readSensorData()) {
+            result |= (1 << i);
+        }
+    }
+
+    return result;
+}
+
+#ifdef DHT22_ARRAY_SHARED_PORT
+/*!
+ * \brief Read all sensors on the same IO port in one transfer.
+ * \details
+ *      All data pins are pulled low together and released together. Global interrupts are
+ *      disabled while the IO port input register is sampled. Each sample is compared with the
+ *      previous sample and the bits of all sensors are decoded on the fly:
+ *      - Edge 0 and 1: Sensor acknowledge
+ *      - Odd edges: Rising edge, end of a bit low pulse
+ *      - Even edges from 4: Falling edge, end of a bit high pulse
+ *
+ *      Each edge is timestamped with the free running Timer0 counter TCNT0, which the Arduino core
+ *      runs at clock / 64 for millis() and which keeps counting with interrupts disabled. Loop
+ *      iterations which decode an edge take longer than iterations without an edge, so counting
+ *      iterations would stretch the pulses of sensors with more edges. Timer0 wraps after 256
+ *      ticks (1 ms at 16 MHz), which is longer than the pulse timeout. A bit is set when the high
+ *      pulse is longer than the low pulse. The transfer ends when no remaining data pin changed
+ *      for DHT22_ARRAY_TIMEOUT_TICKS since the last edge, measured with TCNT0 as well.
+ * \return
+ *      Bit mask of successful conversions.
+ */
+uint8_t DHT22Array::readSensorDataSharedPort()
+{
+    uint8_t port = digitalPinToPort(_sensors[0]->_pin);
+    const volatile DHT22GpioTraits::reg_t *inputRegister = _sensors[0]->_inputRegister;
+    volatile DHT22GpioTraits::reg_t *modeRegister = portModeRegister(port);
+    volatile DHT22GpioTraits::reg_t *outputRegister = portOutputRegister(port);
+    uint8_t edgeTimestamp[DHT22_ARRAY_MAX_SENSORS];
+    uint8_t lowWidth[DHT22_ARRAY_MAX_SENSORS];
+    uint8_t numEdges[DHT22_ARRAY_MAX_SENSORS];
+    uint8_t timestamp;
+    uint8_t idleTimestamp;
+    uint8_t mask = 0;
+    uint8_t pending;
+    uint8_t sample;
+    uint8_t sampleLast;
+    uint8_t changed;
+    uint8_t result = 0;
+
+    for (uint8_t i = 0; i < _numSensors; i++) {
+        mask |= _sensors[i]->_bitMask;
+        memset(_sensors[i]->_data, 0, sizeof(_sensors[i]->_data));
+        _sensors[i]->_lastMeasurementTimestamp = _lastMeasurementTimestamp;
+        numEdges[i] = 0;
+        edgeTimestamp[i] = 0;
+        lowWidth[i] = 0;
+    }
+
+    // Data pins high (pull-up)
+    noInterrupts();
+    *modeRegister &= ~mask;
+    *outputRegister |= mask;
+    interrupts();
+    delay(DHT22_START_HIGH_US / 1000);
+
+    // Change data pins to output, low
+    noInterrupts();
+    *outputRegister &= ~mask;
+    *modeRegister |= mask;
+    interrupts();
+    delay(DHT22_START_LOW_US / 1000);
+
+    // Disable interrupts during data transfer
+    noInterrupts();
+
+    // Data pins to input (pull-up)
+    *modeRegister &= ~mask;
+    *outputRegister |= mask;
+    delayMicroseconds(10);
+
+    pending = mask;
+    sampleLast = *inputRegister & mask;
+    idleTimestamp = TCNT0;
+
+    while (pending) {
+        sample = *inputRegister & mask;
+
+        changed = (sample ^ sampleLast) & pending;
+        if (changed == 0) {
+            // The timeout is shorter than the Timer0 wrap, so the 8-bit difference is exact
+            if ((uint8_t)(TCNT0 - idleTimestamp) >= DHT22_ARRAY_TIMEOUT_TICKS) {
+                // Timeout: No edge on any remaining data pin
+                break;
+            }
+            continue;
+        }
+
+        // Timestamp of all edges in this sample, a constant number of instructions after the
+        // sample
+        timestamp = TCNT0;
+        idleTimestamp = timestamp;
+        sampleLast = sample;
+
+        for (uint8_t i = 0; i < _numSensors; i++) {
+            uint8_t bit = _sensors[i]->_bitMask;
+            uint8_t edge;
+
+            if ((changed & bit) == 0) {
+                continue;
+            }
+
+            edge = numEdges[i]++;
+
+            // Even edges must be falling, odd edges rising
+            if (((edge & 1) != 0) != ((sample & bit) != 0)) {
+                pending &= ~bit;
+                continue;
+            }
+
+            if (edge & 1) {
+                // End of low pulse
+                lowWidth[i] = (uint8_t)(timestamp - edgeTimestamp[i]);
+            } else if (edge >= 4) {
+                // End of high pulse: Store data bit
+                uint8_t *data = &_sensors[i]->_data[(edge - 4) / 16];
+
+                *data <<= 1;
+                if ((uint8_t)(timestamp - edgeTimestamp[i]) > lowWidth[i]) {
+                    *data |= 1;
+                }
+
+                if (edge == (DHT22_NUM_EDGES - 2)) {
+                    // Last data bit received
+                    pending &= ~bit;
+                    result |= (1 << i);
+                }
+            }
+
+            edgeTimestamp[i] = timestamp;
+        }
+    }
+
+    // Enable interrupts
+    interrupts();
+
+    // Check data parity of each sensor
+    for (uint8_t i = 0; i < _numSensors; i++) {
+        _sensors[i]->_numAttempts = 1;
+
+        if (numEdges[i] < 2) {
+            // No sensor acknowledge
+            _sensors[i]->setStatus(DHT22_STATUS_START_ERROR);
+        } else if ((result & (1 << i)) == 0) {
+            _sensors[i]->setStatus(DHT22_STATUS_TIMEOUT);
+        } else if (_sensors[i]->checkParity() != true) {
+            result &= ~(1 << i);
+            _sensors[i]->setStatus(DHT22_STATUS_PARITY_ERROR);
+        } else {
+            _sensors[i]->setStatus(DHT22_STATUS_OK);
+        }
+
+        _sensors[i]->publishSnapshot();
+    }
+
+    return result;
+}
+#endif
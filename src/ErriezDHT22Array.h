@@ -0,0 +1,92 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDHT22Array.h
+ * \brief Read multiple DHT22 (AM2302/AM2303) sensors in one interleaved transfer
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#ifndef ERRIEZ_DHT22_ARRAY_H_
+#define ERRIEZ_DHT22_ARRAY_H_
+
+#include "ErriezDHT22.h"
+
+//! Maximum number of sensors in a DHT22Array (Number of bits in an AVR IO port)
+#define DHT22_ARRAY_MAX_SENSORS     8
+
+#if defined(__AVR) || defined(MOCK_ARDUINO)
+//! Shared IO port transfer supported
+#define DHT22_ARRAY_SHARED_PORT
+//! Pulse timeout of the shared IO port transfer in Timer0 ticks (CPU clock / 64)
+#define DHT22_ARRAY_TIMEOUT_TICKS   ((DHT22_PULSE_TIMEOUT_US * (F_CPU / 1000000UL)) / 64)
+#endif
+
+/*!
+ * \brief DHT22 sensor array class
+ * \details
+ *      On AVR targets, all data pins on the same IO port are pulled low together, released
+ *      together and sampled with a single IO port register read per loop iteration. Edges are
+ *      timestamped with the Timer0 counter of the Arduino core, which is not reconfigured. Up to 8
+ *      sensors are read in one start condition and one interrupts-off window of ~5 ms, instead
+ *      of ~35 ms per sensor.
+ *
+ *      On other targets, when the data pins are not on the same IO port, or when a sensor has a
+ *      power pin (DHT22::setPowerPin()), the sensors are read one after another with
+ *      DHT22::readSensorData().
+ *
+ *      The shared IO port transfer reads each sensor once. Read retries (DHT22::setRetries()) and
+ *      the backoff of sensors without acknowledge (DHT22::setBackoff()) are not applied: A failed
+ *      sensor is read again in the next transfer, DHT22_MIN_READ_INTERVAL later.
+ *
+ *      The result of each sensor is stored in the DHT22 object, so readTemperature() and
+ *      readHumidity() of each sensor can be used after a read.
+ */
+class DHT22Array
+{
+public:
+    DHT22Array(DHT22 **sensors, uint8_t numSensors);
+    bool begin();
+    bool available();
+    uint8_t readSensorData();
+
+private:
+    //! Sensor objects
+    DHT22 **_sensors;
+    //! Number of sensors
+    uint8_t _numSensors;
+    //! All data pins are on the same IO port
+    bool _sharedPort;
+    //! Timestamp of the last completed read
+    unsigned long _lastMeasurementTimestamp;
+
+    uint8_t readSensorDataSequential();
+#ifdef DHT22_ARRAY_SHARED_PORT
+    uint8_t readSensorDataSharedPort();
+#endif
+};
+
+#endif // ERRIEZ_DHT22_ARRAY_H_
@@ -0,0 +1,154 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDHT22Gpio.h
+ * \brief Direct GPIO input register access for the DHT22 library
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#ifndef ERRIEZ_DHT22_GPIO_H_
+#define ERRIEZ_DHT22_GPIO_H_
+
+#include <Arduino.h>
+
+/*!
+ * \brief GPIO input traits, selected at compile time for the target architecture
+ * \details
+ *      inputRegister() returns the GPIO input register of a pin, or NULL when the pin must be
+ *      read with digitalRead():
+ *      - AVR:      PINx
+ *      - ESP8266:  GPI (GPIO0..15, GPIO16 uses digitalRead())
+ *      - ESP32:    GPIO.in / GPIO.in1
+ *      - SAM:      PIO_PDSR
+ *      - SAMD:     PORT->Group[].IN
+ *      - Host:     Simulated IO port registers of the mock Arduino HAL (test/mock)
+ *      - Other:    digitalRead()
+ */
+struct DHT22GpioTraits
+{
+#if defined(MOCK_ARDUINO)
+    //! GPIO input register type: IO port register of the mock Arduino HAL
+    typedef MockRegister reg_t;
+#elif defined(__AVR)
+    //! GPIO input register type
+    typedef uint8_t reg_t;
+#else
+    //! GPIO input register type
+    typedef uint32_t reg_t;
+#endif
+
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32) || \
+    defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD) || defined(MOCK_ARDUINO)
+    //! Direct GPIO input register reads supported
+    static const bool fastRead = true;
+
+    /*!
+     * \brief Get GPIO input register of a pin.
+     * \param pin Arduino pin number.
+     * \return Pointer to GPIO input register, or NULL when not supported for this pin.
+     */
+    static const volatile reg_t *inputRegister(uint8_t pin)
+    {
+#if defined(ESP8266)
+        // GPIO16 is not in the GPI register
+        if (pin >= 16) {
+            return NULL;
+        }
+#endif
+        return (const volatile reg_t *)portInputRegister(digitalPinToPort(pin));
+    }
+
+    /*!
+     * \brief Get bit mask of a pin in the GPIO input register.
+     * \param pin Arduino pin number.
+     * \return Bit mask.
+     */
+    static reg_t bitMask(uint8_t pin)
+    {
+        return (reg_t)digitalPinToBitMask(pin);
+    }
+#else
+    //! Direct GPIO input register reads not supported
+    static const bool fastRead = false;
+
+    /*!
+     * \brief Get GPIO input register of a pin.
+     * \param pin Arduino pin number.
+     * \return NULL: Use digitalRead().
+     */
+    static const volatile reg_t *inputRegister(uint8_t pin)
+    {
+        (void)pin;
+        return NULL;
+    }
+
+    /*!
+     * \brief Get bit mask of a pin in the GPIO input register.
+     * \param pin Arduino pin number.
+     * \return 0: Use digitalRead().
+     */
+    static reg_t bitMask(uint8_t pin)
+    {
+        (void)pin;
+        return 0;
+    }
+#endif
+};
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega328PB__) || \
+    defined(__AVR_ATmega168__) || defined(__AVR_ATmega168P__) || defined(__AVR_ATmega88__) || \
+    defined(MOCK_ARDUINO)
+//! Compile-time GPIO input register reads supported by DHT22FastPin
+#define DHT22_FAST_PIN
+
+/*!
+ * \brief Compile-time GPIO input of an Arduino UNO/Nano/Pro Mini pin
+ * \details
+ *      Pin 0..7: PIND, pin 8..13: PINB, pin 14..19 (A0..A5): PINC. The register and bit are
+ *      constant, so read() compiles to a single sbis/sbic instruction in a loop condition.
+ * \tparam Pin
+ *      Arduino pin number.
+ */
+template <uint8_t Pin>
+struct DHT22FastPin
+{
+    static_assert(Pin < 20, "DHT22FastPin: Invalid pin");
+
+    /*!
+     * \brief Read pin.
+     * \return Non-zero when the pin is high.
+     */
+    static inline uint8_t read()
+    {
+        return (Pin < 8) ? (PIND & (1 << Pin)) :
+               (Pin < 14) ? (PINB & (1 << (Pin - 8))) :
+                            (PINC & (1 << (Pin - 14)));
+    }
+};
+#endif
+
+#endif // ERRIEZ_DHT22_GPIO_H_
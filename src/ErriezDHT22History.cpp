@@ -0,0 +1,363 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDHT22History.cpp
+ * \brief Compressed temperature and humidity history for the DHT22 library
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#include "ErriezDHT22History.h"
+
+/*!
+ * \brief Constructor history.
+ * \param buffer
+ *      Ring buffer provided by the application.
+ * \param size
+ *      Size of the ring buffer in Bytes.
+ */
+DHT22History::DHT22History(uint8_t *buffer, uint16_t size) :
+        _buffer(buffer), _numBits((uint32_t)size * 8)
+{
+    if (_buffer == NULL) {
+        _numBits = 0;
+    }
+
+    clear();
+}
+
+/*!
+ * \brief Remove all samples.
+ */
+void DHT22History::clear()
+{
+    _readPosition = 0;
+    _writePosition = 0;
+    _numBitsUsed = 0;
+    _numSamples = 0;
+}
+
+/*!
+ * \brief Add sample and evict the oldest samples when the buffer is full.
+ * \details
+ *      When the encoded sample does not fit in the buffer, which is only possible with a buffer
+ *      smaller than DHT22_HISTORY_MIN_SIZE, the history restarts with this sample.
+ * \param timestamp
+ *      Timestamp in seconds.
+ * \param temperature
+ *      Signed temperature with last digit after the point.
+ * \param humidity
+ *      Humidity with last digit after the point.
+ * \retval true
+ *      Sample added.
+ * \retval false
+ *      No buffer.
+ */
+bool DHT22History::add(uint32_t timestamp, int16_t temperature, int16_t humidity)
+{
+    int32_t value[DHT22_HISTORY_NUM_VALUES];
+    int32_t delta[DHT22_HISTORY_NUM_VALUES];
+    uint8_t length = 0;
+
+    if (_numBits == 0) {
+        return false;
+    }
+
+    value[0] = (int32_t)timestamp;
+    value[1] = temperature;
+    value[2] = humidity;
+
+    if (_numSamples != 0) {
+        // Calculate deltas and encoded length of the delta-of-deltas, with wrap around of the
+        // timestamp
+        for (uint8_t i = 0; i < DHT22_HISTORY_NUM_VALUES; i++) {
+            delta[i] = (int32_t)((uint32_t)value[i] - (uint32_t)_lastValue[i]);
+            length += encodedLength((int32_t)((uint32_t)delta[i] - (uint32_t)_lastDelta[i]));
+        }
+
+        if (length > _numBits) {
+            // Evicting older samples does not free enough bits: Restart with this sample, so the
+            // encoder does not stay behind the sensor values
+            clear();
+        }
+    }
+
+    if (_numSamples == 0) {
+        // The oldest sample is not stored in the buffer
+        for (uint8_t i = 0; i < DHT22_HISTORY_NUM_VALUES; i++) {
+            _firstValue[i] = value[i];
+            _firstDelta[i] = 0;
+            _lastValue[i] = value[i];
+            _lastDelta[i] = 0;
+        }
+        _numSamples = 1;
+
+        return true;
+    }
+
+    // Evict the oldest samples until the new sample fits
+    while (((_numBitsUsed + length) > _numBits) || (_numSamples == 0xFFFF)) {
+        evict();
+    }
+
+    for (uint8_t i = 0; i < DHT22_HISTORY_NUM_VALUES; i++) {
+        encode((int32_t)((uint32_t)delta[i] - (uint32_t)_lastDelta[i]));
+        _lastValue[i] = value[i];
+        _lastDelta[i] = delta[i];
+    }
+    _numSamples++;
+
+    return true;
+}
+
+/*!
+ * \brief Get number of samples.
+ * \return
+ *      Number of samples in the history.
+ */
+uint16_t DHT22History::getNumSamples()
+{
+    return _numSamples;
+}
+
+/*!
+ * \brief Get number of used bits in the ring buffer.
+ * \return
+ *      Number of used bits.
+ */
+uint32_t DHT22History::getNumBitsUsed()
+{
+    return _numBitsUsed;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private functions
+//--------------------------------------------------------------------------------------------------
+/*!
+ * \brief Evict the oldest sample.
+ * \details
+ *      The second oldest sample is decoded and becomes the oldest sample, so its bits are freed.
+ */
+void DHT22History::evict()
+{
+    int32_t deltaOfDelta;
+
+    if (_numSamples <= 1) {
+        clear();
+        return;
+    }
+
+    for (uint8_t i = 0; i < DHT22_HISTORY_NUM_VALUES; i++) {
+        deltaOfDelta = decode(&_readPosition);
+        _numBitsUsed -= encodedLength(deltaOfDelta);
+
+        _firstDelta[i] = (int32_t)((uint32_t)_firstDelta[i] + (uint32_t)deltaOfDelta);
+        _firstValue[i] = (int32_t)((uint32_t)_firstValue[i] + (uint32_t)_firstDelta[i]);
+    }
+    _numSamples--;
+}
+
+/*!
+ * \brief Write bits at the write position, MSB first.
+ * \param value
+ *      Value.
+ * \param numBits
+ *      Number of bits, 1..32.
+ */
+void DHT22History::writeBits(uint32_t value, uint8_t numBits)
+{
+    while (numBits--) {
+        uint8_t mask = 0x80 >> (_writePosition % 8);
+
+        if (value & (1UL << numBits)) {
+            _buffer[_writePosition / 8] |= mask;
+        } else {
+            _buffer[_writePosition / 8] &= ~mask;
+        }
+
+        if (++_writePosition >= _numBits) {
+            _writePosition = 0;
+        }
+    }
+}
+
+/*!
+ * \brief Read bits, MSB first.
+ * \param position
+ *      Bit position, incremented with the number of bits.
+ * \param numBits
+ *      Number of bits, 1..32.
+ * \return
+ *      Value.
+ */
+uint32_t DHT22History::readBits(uint32_t *position, uint8_t numBits)
+{
+    uint32_t value = 0;
+
+    while (numBits--) {
+        value <<= 1;
+        if (_buffer[*position / 8] & (0x80 >> (*position % 8))) {
+            value |= 1;
+        }
+
+        if (++(*position) >= _numBits) {
+            *position = 0;
+        }
+    }
+
+    return value;
+}
+
+/*!
+ * \brief Write delta-of-delta with the variable length prefix code.
+ * \param value
+ *      Delta-of-delta.
+ */
+void DHT22History::encode(int32_t value)
+{
+    if (value == 0) {
+        writeBits(0x0, 1);
+    } else if ((value >= -2) && (value <= 2)) {
+        // Map -2, -1, 1, 2 to 0..3
+        writeBits(0x2, 2);
+        writeBits((value < 0) ? (value + 2) : (value + 1), 2);
+    } else if ((value >= -32) && (value <= 31)) {
+        writeBits(0x6, 3);
+        writeBits((uint32_t)value & 0x3F, 6);
+    } else if ((value >= -2048) && (value <= 2047)) {
+        writeBits(0xE, 4);
+        writeBits((uint32_t)value & 0xFFF, 12);
+    } else {
+        writeBits(0xF, 4);
+        writeBits((uint32_t)value, 32);
+    }
+
+    _numBitsUsed += encodedLength(value);
+}
+
+/*!
+ * \brief Read delta-of-delta with the variable length prefix code.
+ * \param position
+ *      Bit position, incremented with the encoded length.
+ * \return
+ *      Delta-of-delta.
+ */
+int32_t DHT22History::decode(uint32_t *position)
+{
+    int32_t value;
+
+    if (readBits(position, 1) == 0) {
+        return 0;
+    }
+
+    if (readBits(position, 1) == 0) {
+        value = readBits(position, 2);
+        return (value < 2) ? (value - 2) : (value - 1);
+    }
+
+    if (readBits(position, 1) == 0) {
+        value = readBits(position, 6);
+        return (value & 0x20) ? (value - 0x40) : value;
+    }
+
+    if (readBits(position, 1) == 0) {
+        value = readBits(position, 12);
+        return (value & 0x800) ? (value - 0x1000) : value;
+    }
+
+    return (int32_t)readBits(position, 32);
+}
+
+/*!
+ * \brief Get encoded length of a delta-of-delta.
+ * \param value
+ *      Delta-of-delta.
+ * \return
+ *      Number of bits.
+ */
+uint8_t DHT22History::encodedLength(int32_t value)
+{
+    if (value == 0) {
+        return 1;
+    } else if ((value >= -2) && (value <= 2)) {
+        return 4;
+    } else if ((value >= -32) && (value <= 31)) {
+        return 9;
+    } else if ((value >= -2048) && (value <= 2047)) {
+        return 16;
+    }
+
+    return 36;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Iterator
+//--------------------------------------------------------------------------------------------------
+/*!
+ * \brief Constructor history iterator.
+ * \param history
+ *      History to read.
+ */
+DHT22HistoryIterator::DHT22HistoryIterator(DHT22History *history) :
+        _history(history), _position(history->_readPosition), _index(0)
+{
+}
+
+/*!
+ * \brief Get next sample.
+ * \param sample
+ *      Sample output.
+ * \retval true
+ *      Sample available.
+ * \retval false
+ *      No more samples.
+ */
+bool DHT22HistoryIterator::next(DHT22HistorySample *sample)
+{
+    int32_t deltaOfDelta;
+
+    if (_index >= _history->_numSamples) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < DHT22_HISTORY_NUM_VALUES; i++) {
+        if (_index == 0) {
+            _value[i] = _history->_firstValue[i];
+            _delta[i] = _history->_firstDelta[i];
+        } else {
+            deltaOfDelta = _history->decode(&_position);
+            _delta[i] = (int32_t)((uint32_t)_delta[i] + (uint32_t)deltaOfDelta);
+            _value[i] = (int32_t)((uint32_t)_value[i] + (uint32_t)_delta[i]);
+        }
+    }
+    _index++;
+
+    sample->timestamp = (uint32_t)_value[0];
+    sample->temperature = (int16_t)_value[1];
+    sample->humidity = (int16_t)_value[2];
+
+    return true;
+}
@@ -0,0 +1,138 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDHT22History.h
+ * \brief Compressed temperature and humidity history for the DHT22 library
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#ifndef ERRIEZ_DHT22_HISTORY_H_
+#define ERRIEZ_DHT22_HISTORY_H_
+
+#include <Arduino.h>
+
+//! Number of values per history sample: Timestamp, temperature and humidity
+#define DHT22_HISTORY_NUM_VALUES    3
+
+//! Minimum buffer size in Bytes which holds any sample: 3 values of 36 bits
+#define DHT22_HISTORY_MIN_SIZE      14
+
+/*!
+ * \brief History sample
+ */
+typedef struct {
+    //! Timestamp in seconds
+    uint32_t timestamp;
+    //! Signed temperature with last digit after the point
+    int16_t temperature;
+    //! Humidity with last digit after the point
+    int16_t humidity;
+} DHT22HistorySample;
+
+/*!
+ * \brief Temperature and humidity history in a bit-packed ring buffer
+ * \details
+ *      Each value of a sample is stored as the difference between its delta and the delta of the
+ *      previous sample (delta-of-delta) with a variable length prefix code:
+ *          0                           0 (1 bit)
+ *          10   + 2 bits               -2, -1, 1, 2 (4 bits)
+ *          110  + 6 bits               -32..31 (9 bits)
+ *          1110 + 12 bits              -2048..2047 (16 bits)
+ *          1111 + 32 bits              Any other value (36 bits)
+ *
+ *      With a constant sample interval and slowly changing values, a sample takes 3..12 bits
+ *      instead of 8 Bytes. With a 1 minute interval trace, a 512 Bytes buffer holds 687 samples,
+ *      about 5x the samples of two int16_t arrays of the same size. The oldest samples are evicted
+ *      when the buffer is full. The buffer is provided by the application and should be at least
+ *      DHT22_HISTORY_MIN_SIZE Bytes.
+ */
+class DHT22History
+{
+    friend class DHT22HistoryIterator;
+
+public:
+    DHT22History(uint8_t *buffer, uint16_t size);
+    void clear();
+    bool add(uint32_t timestamp, int16_t temperature, int16_t humidity);
+    uint16_t getNumSamples();
+    uint32_t getNumBitsUsed();
+
+private:
+    //! Ring buffer
+    uint8_t *_buffer;
+    //! Ring buffer size in bits
+    uint32_t _numBits;
+    //! Bit position of the second oldest sample
+    uint32_t _readPosition;
+    //! Bit position for the next sample
+    uint32_t _writePosition;
+    //! Number of used bits
+    uint32_t _numBitsUsed;
+    //! Number of samples, including the oldest sample which is not stored in the buffer
+    uint16_t _numSamples;
+    //! Values of the oldest sample
+    int32_t _firstValue[DHT22_HISTORY_NUM_VALUES];
+    //! Deltas of the oldest sample
+    int32_t _firstDelta[DHT22_HISTORY_NUM_VALUES];
+    //! Values of the newest sample
+    int32_t _lastValue[DHT22_HISTORY_NUM_VALUES];
+    //! Deltas of the newest sample
+    int32_t _lastDelta[DHT22_HISTORY_NUM_VALUES];
+
+    void evict();
+    void writeBits(uint32_t value, uint8_t numBits);
+    uint32_t readBits(uint32_t *position, uint8_t numBits);
+    void encode(int32_t value);
+    int32_t decode(uint32_t *position);
+    static uint8_t encodedLength(int32_t value);
+};
+
+/*!
+ * \brief Read the history from the oldest to the newest sample
+ * \details
+ *      The iterator is invalid after DHT22History::add() or DHT22History::clear().
+ */
+class DHT22HistoryIterator
+{
+public:
+    explicit DHT22HistoryIterator(DHT22History *history);
+    bool next(DHT22HistorySample *sample);
+
+private:
+    //! History
+    DHT22History *_history;
+    //! Bit position of the next sample
+    uint32_t _position;
+    //! Number of samples returned
+    uint16_t _index;
+    //! Values of the last returned sample
+    int32_t _value[DHT22_HISTORY_NUM_VALUES];
+    //! Deltas of the last returned sample
+    int32_t _delta[DHT22_HISTORY_NUM_VALUES];
+};
+
+#endif // ERRIEZ_DHT22_HISTORY_H_
@@ -0,0 +1,354 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDHT22Psychrometrics.cpp
+ * \brief Integer psychrometrics for the DHT22 library
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#include "ErriezDHT22Psychrometrics.h"
+
+//! Number of entries in the saturation vapor pressure table
+#define DHT22_PSYCHRO_TABLE_SIZE \
+    (DHT22_PSYCHRO_MAX_TEMPERATURE - DHT22_PSYCHRO_MIN_TEMPERATURE + 1)
+
+//! Saturation vapor pressure over water in 0.1 Pa from -40 to 80 degree Celsius in 1 degree steps
+static const uint32_t saturationVaporPressureTable[DHT22_PSYCHRO_TABLE_SIZE] PROGMEM = {
+        190,     211,     234,     259,     286,     316,     348,     384,
+        423,     465,     512,     562,     617,     676,     741,     811,
+        887,     970,    1059,    1155,    1260,    1372,    1494,    1625,
+       1766,    1919,    2083,    2259,    2448,    2652,    2870,    3105,
+       3356,    3625,    3913,    4222,    4552,    4904,    5281,    5683,
+       6112,    6569,    7057,    7576,    8129,    8717,    9343,   10008,
+      10714,   11464,   12260,   13105,   14000,   14948,   15953,   17017,
+      18142,   19333,   20591,   21921,   23326,   24809,   26374,   28025,
+      29766,   31601,   33533,   35569,   37711,   39966,   42337,   44830,
+      47450,   50203,   53094,   56128,   59313,   62653,   66156,   69827,
+      73675,   77704,   81924,   86341,   90963,   95797,  100852,  106137,
+     111659,  117427,  123452,  129741,  136304,  143152,  150294,  157742,
+     165504,  173593,  182020,  190796,  199933,  209443,  219338,  229632,
+     240337,  251467,  263035,  275056,  287543,  300512,  313977,  327954,
+     342458,  357506,  373114,  389299,  406077,  423468,  441487,  460155,
+     479489
+};
+
+/*!
+ * \brief Calculate saturation vapor pressure over water.
+ * \param temperature
+ *      Signed temperature with last digit after the point.
+ * \return
+ *      Saturation vapor pressure in 0.1 Pa.
+ */
+uint32_t DHT22Psychrometrics::saturationVaporPressure(int16_t temperature)
+{
+    int16_t offset;
+    uint8_t index;
+    uint8_t fraction;
+    uint32_t low;
+    uint32_t high;
+
+    // Clamp to table range
+    if (temperature < (DHT22_PSYCHRO_MIN_TEMPERATURE * 10)) {
+        temperature = DHT22_PSYCHRO_MIN_TEMPERATURE * 10;
+    } else if (temperature > (DHT22_PSYCHRO_MAX_TEMPERATURE * 10)) {
+        temperature = DHT22_PSYCHRO_MAX_TEMPERATURE * 10;
+    }
+
+    // Table index and fraction in 0.1 degree
+    offset = temperature - (DHT22_PSYCHRO_MIN_TEMPERATURE * 10);
+    index = offset / 10;
+    fraction = offset % 10;
+
+    low = readTable(index);
+    if (fraction == 0) {
+        return low;
+    }
+    high = readTable(index + 1);
+
+    // Linear interpolation
+    return low + (((high - low) * fraction) + 5) / 10;
+}
+
+/*!
+ * \brief Calculate vapor pressure.
+ * \param temperature
+ *      Signed temperature with last digit after the point.
+ * \param humidity
+ *      Relative humidity with last digit after the point.
+ * \return
+ *      Vapor pressure in 0.1 Pa.
+ */
+uint32_t DHT22Psychrometrics::vaporPressure(int16_t temperature, int16_t humidity)
+{
+    // Clamp humidity to 0.0 .. 100.0 %
+    if (humidity < 0) {
+        humidity = 0;
+    } else if (humidity > 1000) {
+        humidity = 1000;
+    }
+
+    // Maximum 479489 * 1000 fits in 32 bits
+    return ((saturationVaporPressure(temperature) * (uint16_t)humidity) + 500) / 1000;
+}
+
+/*!
+ * \brief Calculate dew point.
+ * \details
+ *      The saturation vapor pressure table is searched for the vapor pressure and interpolated.
+ * \param temperature
+ *      Signed temperature with last digit after the point.
+ * \param humidity
+ *      Relative humidity with last digit after the point.
+ * \return
+ *      Dew point in degree Celsius with last digit after the point, clamped to -40.0.
+ */
+int16_t DHT22Psychrometrics::dewPoint(int16_t temperature, int16_t humidity)
+{
+    uint32_t pressure = vaporPressure(temperature, humidity);
+    uint32_t low;
+    uint32_t high;
+    uint8_t first = 0;
+    uint8_t last = DHT22_PSYCHRO_TABLE_SIZE - 1;
+
+    if (pressure <= readTable(first)) {
+        return DHT22_PSYCHRO_MIN_TEMPERATURE * 10;
+    }
+    if (pressure >= readTable(last)) {
+        return DHT22_PSYCHRO_MAX_TEMPERATURE * 10;
+    }
+
+    // Binary search for table[first] < pressure <= table[first + 1]
+    while ((last - first) > 1) {
+        uint8_t middle = (first + last) / 2;
+
+        if (readTable(middle) < pressure) {
+            first = middle;
+        } else {
+            last = middle;
+        }
+    }
+
+    low = readTable(first);
+    high = readTable(last);
+
+    // Inverse linear interpolation in 0.1 degree
+    return ((first + DHT22_PSYCHRO_MIN_TEMPERATURE) * 10) +
+           (int16_t)((((pressure - low) * 10) + ((high - low) / 2)) / (high - low));
+}
+
+/*!
+ * \brief Calculate absolute humidity.
+ * \details
+ *      Absolute humidity = 2.16679 g*K/J * vapor pressure / temperature in Kelvin.
+ * \param temperature
+ *      Signed temperature with last digit after the point.
+ * \param humidity
+ *      Relative humidity with last digit after the point.
+ * \return
+ *      Absolute humidity in g/m3 with last digit after the point.
+ */
+int16_t DHT22Psychrometrics::absoluteHumidity(int16_t temperature, int16_t humidity)
+{
+    uint32_t kelvin;
+
+    if (temperature < (DHT22_PSYCHRO_MIN_TEMPERATURE * 10)) {
+        temperature = DHT22_PSYCHRO_MIN_TEMPERATURE * 10;
+    } else if (temperature > (DHT22_PSYCHRO_MAX_TEMPERATURE * 10)) {
+        temperature = DHT22_PSYCHRO_MAX_TEMPERATURE * 10;
+    }
+
+    // Temperature in 0.1 K
+    kelvin = (uint32_t)(temperature + 2732);
+
+    // 0.1 Pa * 21.67 / 0.1 K = 0.1 g/m3, maximum 479489 * 2167 fits in 32 bits
+    kelvin *= 100;
+    return (int16_t)(((vaporPressure(temperature, humidity) * 2167) + (kelvin / 2)) / kelvin);
+}
+
+/*!
+ * \brief Calculate heat index.
+ * \details
+ *      NOAA heat index: The simple formula is used below 80 degree Fahrenheit, otherwise the
+ *      Rothfusz regression with the low and high humidity adjustments.
+ * \param temperature
+ *      Signed temperature with last digit after the point.
+ * \param humidity
+ *      Relative humidity with last digit after the point.
+ * \return
+ *      Heat index in degree Celsius with last digit after the point. The regression is intended
+ *      for temperatures up to ~50 degree Celsius.
+ */
+int16_t DHT22Psychrometrics::heatIndex(int16_t temperature, int16_t humidity)
+{
+    int32_t f;
+    int32_t t;
+    int32_t r;
+    int32_t tt;
+    int32_t p0;
+    int32_t p1;
+    int32_t p2;
+    int32_t hi;
+
+    if (temperature < (DHT22_PSYCHRO_MIN_TEMPERATURE * 10)) {
+        temperature = DHT22_PSYCHRO_MIN_TEMPERATURE * 10;
+    } else if (temperature > (DHT22_PSYCHRO_MAX_TEMPERATURE * 10)) {
+        temperature = DHT22_PSYCHRO_MAX_TEMPERATURE * 10;
+    }
+    if (humidity < 0) {
+        humidity = 0;
+    } else if (humidity > 1000) {
+        humidity = 1000;
+    }
+
+    // Exact temperature in 0.001 F, humidity in 0.1 %
+    f = (((int32_t)temperature * 18) + 3200) * 10;
+    r = humidity;
+
+    // Simple formula averaged with the temperature, exact in 0.000025 F because the result selects
+    // the regression near 80 F: (T + 0.5 * (T + 61 + (T - 68) * 1.2 + RH * 0.094)) / 2
+    hi = (f * 30) + 610000 + ((f - 68000) * 12) + (r * 94);
+
+    if (hi < (80000L * 40)) {
+        // 0.000025 F to 0.001 F
+        hi = divRound(hi, 40);
+    } else {
+        // Temperature in 0.1 F
+        t = divRound(f, 100);
+
+        // Rothfusz regression in 0.001 F, grouped by powers of RH:
+        // HI = p0 + p1 * RH + p2 * RH^2, with T in F and RH in %
+        tt = (t * t) / 100;
+
+        // p0 = -42.379 + 2.04901523 * T - 0.00683783 * T^2 in 0.001 F
+        p0 = -42379 + divRound(204902 * t, 1000) - divRound(tt * 6838, 1000);
+        // p1 = 10.14333127 - 0.22475541 * T + 0.00122874 * T^2 in 0.00001 F
+        p1 = 1014333 - divRound(224755 * t, 100) + divRound(tt * 12287, 100);
+        // p2 = -0.05481717 + 0.00085282 * T - 0.00000199 * T^2 in 0.000001 F
+        p2 = -54817 + divRound(85282 * t, 1000) - divRound(tt * 199, 100);
+
+        hi = p0 + divRound(p1 * r, 1000) + divRound(divRound(p2 * r, 100) * r, 1000);
+
+        if ((r < 130) && (t >= 800) && (t <= 1120)) {
+            // Low humidity: Subtract (13 - RH) / 4 * sqrt((17 - |T - 95|) / 17)
+            uint32_t b = (uint32_t)(170 - ((t > 950) ? (t - 950) : (950 - t)));
+
+            hi -= divRound((130 - r) * squareRoot((b * 1000000UL) / 170), 40);
+        } else if ((r > 850) && (t >= 800) && (t <= 870)) {
+            // High humidity: Add (RH - 85) / 10 * (87 - T) / 5
+            hi += divRound((r - 850) * (870 - t), 5);
+        }
+    }
+
+    // 0.001 F to 0.1 C, the regression exceeds the int16_t range at high temperature and humidity
+    hi = divRound(hi - 32000, 180);
+    if (hi > INT16_MAX) {
+        hi = INT16_MAX;
+    }
+
+    return (int16_t)hi;
+}
+
+/*!
+ * \brief Calculate humidex.
+ * \details
+ *      Humidex = T + 5 / 9 * (e - 10), with vapor pressure e in hPa.
+ * \param temperature
+ *      Signed temperature with last digit after the point.
+ * \param humidity
+ *      Relative humidity with last digit after the point.
+ * \return
+ *      Humidex in degree Celsius with last digit after the point.
+ */
+int16_t DHT22Psychrometrics::humidex(int16_t temperature, int16_t humidity)
+{
+    int32_t pressure = (int32_t)vaporPressure(temperature, humidity);
+
+    // Vapor pressure 0.1 Pa to 0.1 C: 5 / 9 / 100
+    return temperature + (int16_t)divRound((pressure - 10000) * 5, 900);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private functions
+//--------------------------------------------------------------------------------------------------
+/*!
+ * \brief Read saturation vapor pressure table entry from flash.
+ * \param index
+ *      Table index.
+ * \return
+ *      Saturation vapor pressure in 0.1 Pa.
+ */
+uint32_t DHT22Psychrometrics::readTable(uint8_t index)
+{
+    return pgm_read_dword(&saturationVaporPressureTable[index]);
+}
+
+/*!
+ * \brief Divide and round to nearest.
+ * \param numerator
+ *      Signed numerator.
+ * \param denominator
+ *      Positive denominator.
+ * \return
+ *      Rounded quotient.
+ */
+int32_t DHT22Psychrometrics::divRound(int32_t numerator, int32_t denominator)
+{
+    if (numerator < 0) {
+        return (numerator - (denominator / 2)) / denominator;
+    }
+
+    return (numerator + (denominator / 2)) / denominator;
+}
+
+/*!
+ * \brief Integer square root.
+ * \param value
+ *      Value.
+ * \return
+ *      Square root, rounded down.
+ */
+uint16_t DHT22Psychrometrics::squareRoot(uint32_t value)
+{
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (value >= (result + bit)) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint16_t)result;
+}
@@ -0,0 +1,73 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDHT22Psychrometrics.h
+ * \brief Integer psychrometrics for the DHT22 library
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#ifndef ERRIEZ_DHT22_PSYCHROMETRICS_H_
+#define ERRIEZ_DHT22_PSYCHROMETRICS_H_
+
+#include <Arduino.h>
+
+//! Lowest temperature of the saturation vapor pressure table in degree Celsius
+#define DHT22_PSYCHRO_MIN_TEMPERATURE   -40
+//! Highest temperature of the saturation vapor pressure table in degree Celsius
+#define DHT22_PSYCHRO_MAX_TEMPERATURE   80
+
+/*!
+ * \brief Derived psychrometric values with integer arithmetic
+ * \details
+ *      All functions use the temperature and humidity format of DHT22::readTemperature() and
+ *      DHT22::readHumidity(): Signed int16_t with last digit after the point. No floating point
+ *      math is used.
+ *
+ *      The saturation vapor pressure over water is calculated with the Magnus formula
+ *      es = 611.2 Pa * exp(17.62 * T / (243.12 + T)) from a 1 degree Celsius lookup table in flash
+ *      with linear interpolation. Temperatures are clamped to -40.0 .. 80.0 degree Celsius and
+ *      humidity to 0.0 .. 100.0 %, the range of the sensor.
+ *
+ *      The application must check for the ~0 read error value before calling these functions.
+ */
+class DHT22Psychrometrics
+{
+public:
+    static uint32_t saturationVaporPressure(int16_t temperature);
+    static uint32_t vaporPressure(int16_t temperature, int16_t humidity);
+    static int16_t dewPoint(int16_t temperature, int16_t humidity);
+    static int16_t absoluteHumidity(int16_t temperature, int16_t humidity);
+    static int16_t heatIndex(int16_t temperature, int16_t humidity);
+    static int16_t humidex(int16_t temperature, int16_t humidity);
+
+private:
+    static uint32_t readTable(uint8_t index);
+    static int32_t divRound(int32_t numerator, int32_t denominator);
+    static uint16_t squareRoot(uint32_t value);
+};
+
+#endif // ERRIEZ_DHT22_PSYCHROMETRICS_H_
@@ -0,0 +1,183 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDHT22Scheduler.cpp
+ * \brief Read multiple DHT22 (AM2302/AM2303) sensors with pipelined start conditions
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#include "ErriezDHT22Scheduler.h"
+
+/*!
+ * \brief Constructor DHT22 sensor scheduler.
+ * \param sensors
+ *      Array with pointers to DHT22 sensor objects. Call begin() of each sensor from setup().
+ * \param numSensors
+ *      Number of sensors, maximum DHT22_SCHEDULER_MAX_SENSORS.
+ */
+DHT22Scheduler::DHT22Scheduler(DHT22 **sensors, uint8_t numSensors) :
+        _sensors(sensors), _numSensors(numSensors), _pending(0), _busy(0), _result(0),
+        _slotTimestamp(0), _lastMeasurementTimestamp((uint32_t)-DHT22_MIN_READ_INTERVAL)
+{
+    if (_numSensors > DHT22_SCHEDULER_MAX_SENSORS) {
+        _numSensors = DHT22_SCHEDULER_MAX_SENSORS;
+    }
+}
+
+/*!
+ * \brief Start a sweep when allowed and check if the sweep completed.
+ * \details
+ *      Non-blocking: Call this function from loop(). A new sweep is started when
+ *      DHT22_MIN_READ_INTERVAL elapsed since the start of the previous sweep.
+ * \retval true
+ *      Sweep completed and at least one sensor read was successful.
+ * \retval false
+ *      Sweep in progress, interval between sweeps too short, or all sensor reads failed.
+ */
+bool DHT22Scheduler::available()
+{
+    if (isReady()) {
+        if ((millis() - _lastMeasurementTimestamp) < DHT22_MIN_READ_INTERVAL) {
+            // Interval between sweeps too short
+            return false;
+        }
+
+        startSweep();
+    }
+
+    return poll() && (_result != 0);
+}
+
+/*!
+ * \brief Read data from all sensors.
+ * \details
+ *      This is a blocking wrapper around startSweep() and poll().
+ * \return
+ *      Bit mask of successful conversions. Bit 0 is the first sensor in the array.
+ */
+uint16_t DHT22Scheduler::readSensorData()
+{
+    // Start sweep and wait until completed
+    startSweep();
+    while (!poll()) {
+        yield();
+    }
+
+    return _result;
+}
+
+/*!
+ * \brief Start a non-blocking sweep of all sensors.
+ * \details
+ *      Call poll() repeatedly from loop() until the sweep is completed. This function is ignored
+ *      while a sweep is in progress.
+ */
+void DHT22Scheduler::startSweep()
+{
+    if (!isReady()) {
+        return;
+    }
+
+    // Store last sweep timestamp
+    _lastMeasurementTimestamp = millis();
+
+    _pending = (uint16_t)((1UL << _numSensors) - 1);
+    _result = 0;
+}
+
+/*!
+ * \brief Process a non-blocking sweep.
+ * \details
+ *      Polls the sensors with a conversion in progress and starts the next pending sensor when
+ *      its slot is available.
+ * \retval true
+ *      No sweep in progress, the result is available with getResult().
+ * \retval false
+ *      Sweep in progress.
+ */
+bool DHT22Scheduler::poll()
+{
+    for (uint8_t i = 0; i < _numSensors; i++) {
+        DHT22 *sensor = _sensors[i];
+        uint16_t bit = (1 << i);
+
+        if (_busy & bit) {
+            if (sensor->poll()) {
+                // Conversion completed
+                _busy &= ~bit;
+                if (sensor->_status == DHT22_STATUS_OK) {
+                    _result |= bit;
+                }
+            }
+        } else if (_pending & bit) {
+            if ((_busy != 0) && ((micros() - _slotTimestamp) < DHT22_SCHEDULER_SLOT_US)) {
+                // Previous sensor started less than one data transfer ago
+                continue;
+            }
+
+            if ((millis() - sensor->_lastMeasurementTimestamp) < DHT22_MIN_READ_INTERVAL) {
+                // Interval between reads of this sensor too short
+                continue;
+            }
+
+            _pending &= ~bit;
+            sensor->startConversion();
+
+            if (sensor->isReady()) {
+                // Skipped by the backoff of a sensor without acknowledge, or bus error
+                continue;
+            }
+
+            _busy |= bit;
+            _slotTimestamp = micros();
+        }
+    }
+
+    return isReady();
+}
+
+/*!
+ * \brief Check if a sweep is in progress.
+ * \retval true
+ *      No sweep in progress.
+ * \retval false
+ *      Sweep in progress, call poll().
+ */
+bool DHT22Scheduler::isReady()
+{
+    return (_pending == 0) && (_busy == 0);
+}
+
+/*!
+ * \brief Get the result of the last sweep.
+ * \return
+ *      Bit mask of successful conversions. Bit 0 is the first sensor in the array.
+ */
+uint16_t DHT22Scheduler::getResult()
+{
+    return _result;
+}
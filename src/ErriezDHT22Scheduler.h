@@ -0,0 +1,90 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDHT22Scheduler.h
+ * \brief Read multiple DHT22 (AM2302/AM2303) sensors with pipelined start conditions
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#ifndef ERRIEZ_DHT22_SCHEDULER_H_
+#define ERRIEZ_DHT22_SCHEDULER_H_
+
+#include "ErriezDHT22.h"
+
+//! Maximum number of sensors in a DHT22Scheduler (Number of bits in the result mask)
+#define DHT22_SCHEDULER_MAX_SENSORS 16
+
+//! Start condition offset between two sensors in micro seconds: Duration of one data transfer
+#define DHT22_SCHEDULER_SLOT_US     5000
+
+/*!
+ * \brief DHT22 sensor scheduler class
+ * \details
+ *      Reads sensors on any data pin with overlapping conversions. The start condition of each
+ *      sensor is started DHT22_SCHEDULER_SLOT_US after the previous sensor, so the ~30 ms start
+ *      condition of the next sensors runs while the previous sensor is transferring data. A sweep
+ *      of N sensors takes ~30 ms + N * 5 ms, instead of N * 35 ms with DHT22::readSensorData().
+ *
+ *      In polling capture mode, the data transfer of one sensor (~5 ms with interrupts disabled)
+ *      extends the start condition of the next sensor. In interrupt capture mode, a sensor keeps
+ *      its data pin low until the previous sensor completed its capture.
+ *
+ *      A sensor is started when DHT22_MIN_READ_INTERVAL elapsed since its own last conversion.
+ *      Sensors skipped by the backoff of DHT22::startConversion() do not use a slot.
+ *
+ *      The result of each sensor is stored in the DHT22 object, so readTemperature() and
+ *      readHumidity() of each sensor can be used after a sweep.
+ */
+class DHT22Scheduler
+{
+public:
+    DHT22Scheduler(DHT22 **sensors, uint8_t numSensors);
+    bool available();
+    uint16_t readSensorData();
+    void startSweep();
+    bool poll();
+    bool isReady();
+    uint16_t getResult();
+
+private:
+    //! Sensor objects
+    DHT22 **_sensors;
+    //! Number of sensors
+    uint8_t _numSensors;
+    //! Bit mask of sensors not yet started in this sweep
+    uint16_t _pending;
+    //! Bit mask of sensors with a conversion in progress
+    uint16_t _busy;
+    //! Bit mask of successful conversions in this sweep
+    uint16_t _result;
+    //! Timestamp in micro seconds of the last started sensor
+    unsigned long _slotTimestamp;
+    //! Timestamp of the last started sweep
+    unsigned long _lastMeasurementTimestamp;
+};
+
+#endif // ERRIEZ_DHT22_SCHEDULER_H_
@@ -0,0 +1,147 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDHT22Trigger.cpp
+ * \brief Threshold and change triggers for the DHT22 library
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#include "ErriezDHT22.h"
+#include "ErriezDHT22Trigger.h"
+
+/*!
+ * \brief Constructor trigger.
+ * \param type
+ *      DHT22_TRIGGER_ABOVE, DHT22_TRIGGER_BELOW, DHT22_TRIGGER_CHANGE or DHT22_TRIGGER_RATE.
+ * \param source
+ *      DHT22_TRIGGER_TEMPERATURE or DHT22_TRIGGER_HUMIDITY.
+ * \param threshold
+ *      Threshold with last digit after the point, or rate per minute for DHT22_TRIGGER_RATE.
+ *      Not used for DHT22_TRIGGER_CHANGE.
+ * \param deadband
+ *      Hysteresis for DHT22_TRIGGER_ABOVE and DHT22_TRIGGER_BELOW, minimum change for
+ *      DHT22_TRIGGER_CHANGE (0: any change). Not used for DHT22_TRIGGER_RATE.
+ * \param callback
+ *      Function called when the trigger fires.
+ */
+DHT22Trigger::DHT22Trigger(uint8_t type, uint8_t source, int16_t threshold, int16_t deadband,
+                           DHT22TriggerCallback callback) :
+        _owner(NULL), _next(NULL), _callback(callback), _threshold(threshold), _deadband(deadband),
+        _type(type), _source(source)
+{
+    reset();
+}
+
+/*!
+ * \brief Destructor trigger.
+ * \details
+ *      Removes the trigger from the list of the sensor which registered it.
+ */
+DHT22Trigger::~DHT22Trigger()
+{
+#if DHT22_TRIGGERS
+    if (_owner != NULL) {
+        _owner->removeTrigger(this);
+    }
+#endif
+}
+
+/*!
+ * \brief Rearm threshold trigger and clear reference value.
+ */
+void DHT22Trigger::reset()
+{
+    _referenceTimestamp = 0;
+    _referenceValue = 0;
+    _armed = true;
+    _hasReference = false;
+}
+
+/*!
+ * \brief Evaluate trigger and call the callback when it fires.
+ * \param sensor
+ *      Sensor which completed the conversion.
+ * \param value
+ *      Temperature or humidity with last digit after the point.
+ * \param timestamp
+ *      Timestamp of the conversion in milli seconds.
+ */
+void DHT22Trigger::evaluate(DHT22 *sensor, int16_t value, unsigned long timestamp)
+{
+    int32_t difference = (int32_t)value - _referenceValue;
+    bool fire = false;
+
+    switch (_type) {
+        case DHT22_TRIGGER_ABOVE:
+            if (_armed && (value > _threshold)) {
+                fire = true;
+                _armed = false;
+            } else if (!_armed && ((int32_t)value <= ((int32_t)_threshold - _deadband))) {
+                _armed = true;
+            }
+            break;
+
+        case DHT22_TRIGGER_BELOW:
+            if (_armed && (value < _threshold)) {
+                fire = true;
+                _armed = false;
+            } else if (!_armed && ((int32_t)value >= ((int32_t)_threshold + _deadband))) {
+                _armed = true;
+            }
+            break;
+
+        case DHT22_TRIGGER_CHANGE:
+            if (!_hasReference || (abs(difference) > _deadband)) {
+                fire = true;
+                _referenceValue = value;
+                _hasReference = true;
+            }
+            break;
+
+        case DHT22_TRIGGER_RATE:
+            // Rate per minute: difference * 60000 ms / interval, interval in 10 ms
+            if (_hasReference && ((timestamp - _referenceTimestamp) >= 10)) {
+                int32_t interval = (int32_t)((timestamp - _referenceTimestamp) / 10);
+                int32_t rate = (difference * 6000) / interval;
+
+                if (abs(rate) >= _threshold) {
+                    fire = true;
+                }
+            }
+            _referenceValue = value;
+            _referenceTimestamp = timestamp;
+            _hasReference = true;
+            break;
+
+        default:
+            break;
+    }
+
+    if (fire && (_callback != NULL)) {
+        _callback(sensor, this, value);
+    }
+}
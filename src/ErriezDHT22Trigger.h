@@ -0,0 +1,115 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDHT22Trigger.h
+ * \brief Threshold and change triggers for the DHT22 library
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#ifndef ERRIEZ_DHT22_TRIGGER_H_
+#define ERRIEZ_DHT22_TRIGGER_H_
+
+#include <Arduino.h>
+
+//! Trigger type: Value rises above threshold, rearmed at or below threshold - deadband
+#define DHT22_TRIGGER_ABOVE         0
+//! Trigger type: Value falls below threshold, rearmed at or above threshold + deadband
+#define DHT22_TRIGGER_BELOW         1
+//! Trigger type: Value changed more than deadband since the last trigger
+#define DHT22_TRIGGER_CHANGE        2
+//! Trigger type: Rate of change since the previous conversion at least threshold per minute
+#define DHT22_TRIGGER_RATE          3
+
+//! Trigger source: Temperature
+#define DHT22_TRIGGER_TEMPERATURE   0
+//! Trigger source: Humidity
+#define DHT22_TRIGGER_HUMIDITY      1
+
+class DHT22;
+class DHT22Trigger;
+
+/*!
+ * \brief Trigger callback
+ * \param sensor Sensor which completed the conversion.
+ * \param trigger Trigger which fired.
+ * \param value Temperature or humidity with last digit after the point.
+ */
+typedef void (*DHT22TriggerCallback)(DHT22 *sensor, DHT22Trigger *trigger, int16_t value);
+
+/*!
+ * \brief Threshold, deadband and rate of change trigger
+ * \details
+ *      Triggers are registered with DHT22::addTrigger() and evaluated once per successful
+ *      conversion with the temperature and humidity returned by readTemperature() and
+ *      readHumidity(). The callback is called from poll() or readSensorData(). In background
+ *      sampling mode, the callback is called from DHT22::available() and not from update(), which
+ *      may run in a timer interrupt. Triggers are not evaluated when available() is not called.
+ *
+ *      The trigger objects are linked in a list, so each trigger can be added to one sensor only.
+ *      DHT22::addTrigger() rejects a trigger of another sensor until it is removed with
+ *      DHT22::removeTrigger() or the other sensor is destroyed. A trigger which is destroyed
+ *      removes itself from the list of its sensor.
+ */
+class DHT22Trigger
+{
+    friend class DHT22;
+
+public:
+    DHT22Trigger(uint8_t type, uint8_t source, int16_t threshold, int16_t deadband,
+                 DHT22TriggerCallback callback);
+    ~DHT22Trigger();
+    void reset();
+
+private:
+    //! Sensor which registered the trigger, NULL when not registered
+    DHT22 *_owner;
+    //! Next trigger in the list of the sensor
+    DHT22Trigger *_next;
+    //! Callback
+    DHT22TriggerCallback _callback;
+    //! Reference timestamp in milli seconds for DHT22_TRIGGER_RATE
+    unsigned long _referenceTimestamp;
+    //! Threshold, or rate per minute for DHT22_TRIGGER_RATE
+    int16_t _threshold;
+    //! Deadband
+    int16_t _deadband;
+    //! Reference value for DHT22_TRIGGER_CHANGE and DHT22_TRIGGER_RATE
+    int16_t _referenceValue;
+    //! Trigger type DHT22_TRIGGER_ABOVE, DHT22_TRIGGER_BELOW, DHT22_TRIGGER_CHANGE or
+    //! DHT22_TRIGGER_RATE
+    uint8_t _type;
+    //! Trigger source DHT22_TRIGGER_TEMPERATURE or DHT22_TRIGGER_HUMIDITY
+    uint8_t _source;
+    //! Threshold trigger can fire
+    bool _armed;
+    //! Reference value valid
+    bool _hasReference;
+
+    void evaluate(DHT22 *sensor, int16_t value, unsigned long timestamp);
+};
+
+#endif // ERRIEZ_DHT22_TRIGGER_H_
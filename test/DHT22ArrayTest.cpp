@@ -0,0 +1,188 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file DHT22ArrayTest.cpp
+ * \brief Shared IO port transfer and sequential fallback of DHT22Array
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ *
+ *      Pin 2..4 are on the simulated IO port D, pin 8 on port B.
+ */
+
+#include <ErriezDHT22.h>
+#include <ErriezDHT22Array.h>
+
+#include "DHT22Test.h"
+#include "DHT22Waveform.h"
+
+#define NUM_SENSORS     3
+
+//! Data pins on IO port D
+static const uint8_t pins[NUM_SENSORS] = { 2, 3, 4 };
+
+static void testSharedPort()
+{
+    DHT22Waveform sensor0(pins[0]);
+    DHT22Waveform sensor1(pins[1]);
+    DHT22Waveform sensor2(pins[2]);
+    DHT22 dht22_0(pins[0]);
+    DHT22 dht22_1(pins[1]);
+    DHT22 dht22_2(pins[2]);
+    DHT22 *sensors[NUM_SENSORS] = { &dht22_0, &dht22_1, &dht22_2 };
+    DHT22Array array(sensors, NUM_SENSORS);
+
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        sensors[i]->begin();
+    }
+    TEST_ASSERT(array.begin());
+
+    // All sensors in one start condition
+    sensor0.setData(235, 523);
+    sensor1.setData(-55, 800);
+    sensor2.setData(0, 1000);
+    TEST_ASSERT(array.available());
+    TEST_ASSERT_EQUAL(1, sensor0.getNumStarts());
+    TEST_ASSERT_EQUAL(1, sensor1.getNumStarts());
+    TEST_ASSERT_EQUAL(1, sensor2.getNumStarts());
+    TEST_ASSERT_EQUAL(235, dht22_0.readTemperature());
+    TEST_ASSERT_EQUAL(523, dht22_0.readHumidity());
+    TEST_ASSERT_EQUAL(-55, dht22_1.readTemperature());
+    TEST_ASSERT_EQUAL(800, dht22_1.readHumidity());
+    TEST_ASSERT_EQUAL(0, dht22_2.readTemperature());
+    TEST_ASSERT_EQUAL(1000, dht22_2.readHumidity());
+    TEST_ASSERT_EQUAL(DHT22_STATUS_OK, dht22_2.getMeasurement().status);
+    TEST_ASSERT_EQUAL(1, dht22_2.getMeasurement().attempts);
+
+    // Minimum read interval
+    TEST_ASSERT(!array.available());
+    TEST_ASSERT_EQUAL(1, sensor0.getNumStarts());
+    delay(DHT22_MIN_READ_INTERVAL);
+
+    // Errors of each sensor, the other sensors are not affected
+    sensor0.setResponse(DHT22Waveform::frame(100, 200, DHT22_WAVEFORM_NO_ACK));
+    sensor1.setResponse(DHT22Waveform::frame(100, 200, DHT22_WAVEFORM_TRUNCATE, 20));
+    sensor2.setResponse(DHT22Waveform::frame(100, 200, DHT22_WAVEFORM_PARITY));
+    TEST_ASSERT_EQUAL(0, array.readSensorData());
+    TEST_ASSERT_EQUAL(DHT22_STATUS_START_ERROR, dht22_0.getMeasurement().status);
+    TEST_ASSERT_EQUAL(DHT22_STATUS_TIMEOUT, dht22_1.getMeasurement().status);
+    TEST_ASSERT_EQUAL(DHT22_STATUS_PARITY_ERROR, dht22_2.getMeasurement().status);
+    delay(DHT22_MIN_READ_INTERVAL);
+
+    // Not retried in the shared transfer
+    sensor0.setData(111, 222);
+    sensor1.setResponse(DHT22Waveform::frame(100, 200, DHT22_WAVEFORM_TRUNCATE, 20));
+    sensor2.setData(333, 444);
+    TEST_ASSERT_EQUAL(0x05, array.readSensorData());
+    TEST_ASSERT_EQUAL(3, sensor1.getNumStarts());
+    TEST_ASSERT_EQUAL(1, dht22_1.getMeasurement().attempts);
+    TEST_ASSERT_EQUAL(111, dht22_0.readTemperature());
+    TEST_ASSERT_EQUAL(444, dht22_2.readHumidity());
+}
+
+/*!
+ * \brief Read without sensor acknowledge and return the duration after the start condition.
+ */
+static unsigned long timeoutDuration(DHT22Array &array)
+{
+    unsigned long start = micros();
+
+    TEST_ASSERT_EQUAL(0, array.readSensorData());
+
+    return micros() - start - (DHT22_START_HIGH_US + DHT22_START_LOW_US);
+}
+
+static void testTimeout()
+{
+    DHT22Waveform sensor0(pins[0]);
+    DHT22Waveform sensor1(pins[1]);
+    DHT22 dht22_0(pins[0]);
+    DHT22 dht22_1(pins[1]);
+    DHT22 *sensors[2] = { &dht22_0, &dht22_1 };
+    DHT22Array array(sensors, 2);
+    uint32_t callNs = mockCallNs;
+    unsigned long duration;
+
+    dht22_0.begin();
+    dht22_1.begin();
+    TEST_ASSERT(array.begin());
+
+    sensor0.setResponse(DHT22Waveform::frame(0, 0, DHT22_WAVEFORM_NO_ACK));
+    sensor1.setResponse(DHT22Waveform::frame(0, 0, DHT22_WAVEFORM_NO_ACK));
+
+    // The timeout is measured with Timer0 and does not depend on the loop time
+    for (uint32_t ns = 100; ns <= 2000; ns *= 4) {
+        mockCallNs = ns;
+        duration = timeoutDuration(array);
+        TEST_ASSERT(duration >= DHT22_PULSE_TIMEOUT_US);
+        TEST_ASSERT(duration <= (DHT22_PULSE_TIMEOUT_US + 50));
+        TEST_ASSERT_EQUAL(DHT22_STATUS_START_ERROR, dht22_1.getMeasurement().status);
+    }
+
+    mockCallNs = callNs;
+}
+
+static void testSequential()
+{
+    DHT22Waveform sensor0(pins[0]);
+    DHT22Waveform sensor1(8);
+    DHT22 dht22_0(pins[0]);
+    DHT22 dht22_1(8);
+    DHT22 *sensors[2] = { &dht22_0, &dht22_1 };
+    DHT22Array array(sensors, 2);
+
+    dht22_0.begin();
+    dht22_1.begin();
+
+    // Different IO ports
+    TEST_ASSERT(!array.begin());
+    sensor0.setData(235, 523);
+    sensor1.setData(-55, 800);
+    TEST_ASSERT_EQUAL(0x03, array.readSensorData());
+    TEST_ASSERT_EQUAL(235, dht22_0.readTemperature());
+    TEST_ASSERT_EQUAL(-55, dht22_1.readTemperature());
+
+#if DHT22_POWER_CONTROL
+    // A sensor with a power pin is read with readSensorData()
+    DHT22Waveform sensor2(pins[1]);
+    DHT22 dht22_2(pins[1]);
+    DHT22 *sharedPort[2] = { &dht22_0, &dht22_2 };
+    DHT22Array powered(sharedPort, 2);
+
+    dht22_2.begin();
+    TEST_ASSERT(powered.begin());
+    dht22_2.setPowerPin(20, 100);
+    TEST_ASSERT(!powered.begin());
+#endif
+}
+
+int main()
+{
+    TEST_RUN(testSharedPort);
+    TEST_RUN(testTimeout);
+    TEST_RUN(testSequential);
+
+    return TEST_RESULT();
+}
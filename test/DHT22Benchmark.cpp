@@ -0,0 +1,56 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file DHT22Benchmark.cpp
+ * \brief Host variant of the DHT22Benchmark example
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ *
+ *      Runs the unmodified sketch with the mock Arduino HAL and a simulated sensor with nominal
+ *      timing. The CSV output contains simulated time, which only changes when the number of HAL
+ *      calls of the library changes, so average_ns is close to 0. The test fails on a failed
+ *      conversion.
+ */
+
+#include "DHT22Waveform.h"
+
+#include "../examples/DHT22Benchmark/DHT22Benchmark.ino"
+
+int main()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+
+    sensor.setData(215, 553);
+
+    setup();
+
+    // Each loop() call benchmarks one run, followed by the completed benchmark
+    for (uint8_t i = 0; i <= (BENCHMARK_NUM_RUNS * 2); i++) {
+        loop();
+    }
+
+    return 0;
+}
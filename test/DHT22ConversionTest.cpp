@@ -0,0 +1,888 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file DHT22ConversionTest.cpp
+ * \brief Conversion status tests with a scripted sensor waveform
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#include <ErriezDHT22.h>
+
+#include "DHT22Test.h"
+#include "DHT22Waveform.h"
+
+#define DHT22_PIN       2
+#define DHT22_PIN_2     3
+// Pin without IO port registers in the mock HAL
+#define DHT22_PIN_NO_PORT   40
+#define DHT22_POWER_PIN     9
+
+// Capture mode of the current test
+static uint8_t captureMode;
+
+static void setupSensor(DHT22 &dht22)
+{
+    dht22.begin();
+    TEST_ASSERT(dht22.setCaptureMode(captureMode));
+}
+
+static bool completeConversion(DHT22 &dht22)
+{
+    unsigned long start = millis();
+
+    while (!dht22.poll()) {
+        if ((millis() - start) > (2 * DHT22_DEFAULT_RETRY_BUDGET)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void testSuccess()
+{
+    static const int16_t values[][2] = {
+        { 0, 0 }, { 235, 523 }, { -1, 1000 }, { -400, 1 }, { 800, 999 }, { -123, 255 },
+    };
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+
+    setupSensor(dht22);
+
+    for (uint8_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        sensor.setData(values[i][0], values[i][1]);
+
+        TEST_ASSERT(dht22.readSensorData());
+        TEST_ASSERT_EQUAL(values[i][0], dht22.readTemperature());
+        TEST_ASSERT_EQUAL(values[i][1], dht22.readHumidity());
+        TEST_ASSERT_EQUAL(DHT22_STATUS_OK, dht22.getMeasurement().status);
+        TEST_ASSERT_EQUAL(1, dht22.getMeasurement().attempts);
+        TEST_ASSERT_EQUAL(i + 1, sensor.getNumStarts());
+        TEST_ASSERT(sensor.getLastStartLowUs() >= DHT22_START_LOW_US);
+        TEST_ASSERT(mockGetIsr(DHT22_PIN) == NULL);
+
+        delay(DHT22_MIN_READ_INTERVAL);
+    }
+}
+
+static void testParityError()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+
+    setupSensor(dht22);
+
+    // Read and 2 retries fail
+    sensor.setResponse(DHT22Waveform::frame(235, 523, DHT22_WAVEFORM_PARITY));
+
+    TEST_ASSERT(!dht22.readSensorData());
+    TEST_ASSERT_EQUAL(DHT22_STATUS_PARITY_ERROR, dht22.getMeasurement().status);
+    TEST_ASSERT_EQUAL(DHT22_DEFAULT_RETRIES + 1, dht22.getMeasurement().attempts);
+    TEST_ASSERT_EQUAL(DHT22_DEFAULT_RETRIES + 1, sensor.getNumStarts());
+    TEST_ASSERT_EQUAL(~0, dht22.readTemperature());
+    TEST_ASSERT_EQUAL(~0, dht22.readHumidity());
+
+    // First retry succeeds
+    delay(DHT22_MIN_READ_INTERVAL);
+    sensor.setData(235, 523);
+    sensor.script(DHT22Waveform::frame(235, 523, DHT22_WAVEFORM_PARITY));
+
+    TEST_ASSERT(dht22.readSensorData());
+    TEST_ASSERT_EQUAL(2, dht22.getMeasurement().attempts);
+    TEST_ASSERT_EQUAL(235, dht22.readTemperature());
+    TEST_ASSERT_EQUAL(523, dht22.readHumidity());
+}
+
+static void testTimeout()
+{
+    static const uint8_t numBits[] = { 1, 20, 39 };
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+
+    setupSensor(dht22);
+    dht22.setRetries(0);
+
+    for (uint8_t i = 0; i < sizeof(numBits); i++) {
+        unsigned long start;
+
+        sensor.setResponse(DHT22Waveform::frame(235, 523, DHT22_WAVEFORM_TRUNCATE, numBits[i]));
+
+        start = millis();
+        TEST_ASSERT(!dht22.readSensorData());
+        TEST_ASSERT_EQUAL(DHT22_STATUS_TIMEOUT, dht22.getMeasurement().status);
+        TEST_ASSERT_EQUAL(1, dht22.getMeasurement().attempts);
+        TEST_ASSERT((millis() - start) <= DHT22_CONVERSION_MAX_MS);
+        TEST_ASSERT(mockGetIsr(DHT22_PIN) == NULL);
+
+        delay(DHT22_MIN_READ_INTERVAL);
+    }
+
+    // Retries within the budget
+    dht22.setRetries(DHT22_DEFAULT_RETRIES);
+    sensor.clearScript();
+    sensor.script(DHT22Waveform::frame(235, 523, DHT22_WAVEFORM_TRUNCATE, 10));
+    sensor.script(DHT22Waveform::frame(235, 523, DHT22_WAVEFORM_TRUNCATE, 30));
+    sensor.setData(-55, 800);
+
+    TEST_ASSERT(dht22.readSensorData());
+    TEST_ASSERT_EQUAL(3, dht22.getMeasurement().attempts);
+    TEST_ASSERT_EQUAL(-55, dht22.readTemperature());
+    TEST_ASSERT_EQUAL(800, dht22.readHumidity());
+}
+
+static void testRetrySpacing()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+    unsigned long startTimestamp[DHT22_DEFAULT_RETRIES + 1];
+    uint32_t numStarts;
+    unsigned long start;
+    bool done;
+
+    setupSensor(dht22);
+    sensor.setResponse(DHT22Waveform::frame(235, 523, DHT22_WAVEFORM_TRUNCATE, 20));
+
+    // Each retry starts DHT22_MIN_READ_INTERVAL after the previous attempt
+    start = millis();
+    numStarts = 0;
+    dht22.startConversion();
+    do {
+        done = dht22.poll();
+
+        // The polling capture completes the last attempt in the same poll() call
+        if (sensor.getNumStarts() != numStarts) {
+            TEST_ASSERT(numStarts < (DHT22_DEFAULT_RETRIES + 1));
+            if (numStarts >= (DHT22_DEFAULT_RETRIES + 1)) {
+                return;
+            }
+            startTimestamp[numStarts++] = millis();
+        }
+    } while (!done);
+    TEST_ASSERT_EQUAL(DHT22_STATUS_TIMEOUT, dht22.getMeasurement().status);
+    TEST_ASSERT_EQUAL(DHT22_DEFAULT_RETRIES + 1, dht22.getMeasurement().attempts);
+    TEST_ASSERT_EQUAL(DHT22_DEFAULT_RETRIES + 1, numStarts);
+    for (uint8_t i = 1; i < numStarts; i++) {
+        TEST_ASSERT((startTimestamp[i] - startTimestamp[i - 1]) >= DHT22_MIN_READ_INTERVAL);
+    }
+    TEST_ASSERT((millis() - start) <= DHT22_DEFAULT_RETRY_BUDGET);
+
+    // Budget for one retry
+    delay(DHT22_MIN_READ_INTERVAL);
+    dht22.setRetries(3, DHT22_MIN_READ_INTERVAL + DHT22_CONVERSION_MAX_MS);
+    start = millis();
+    TEST_ASSERT(!dht22.readSensorData());
+    TEST_ASSERT_EQUAL(2, dht22.getMeasurement().attempts);
+    TEST_ASSERT((millis() - start) <= (DHT22_MIN_READ_INTERVAL + DHT22_CONVERSION_MAX_MS));
+
+    // Budget shorter than the read interval: No retries
+    delay(DHT22_MIN_READ_INTERVAL);
+    dht22.setRetries(3, DHT22_MIN_READ_INTERVAL);
+    start = millis();
+    TEST_ASSERT(!dht22.readSensorData());
+    TEST_ASSERT_EQUAL(1, dht22.getMeasurement().attempts);
+    TEST_ASSERT((millis() - start) <= DHT22_CONVERSION_MAX_MS);
+}
+
+static void testStartError()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+    unsigned long start;
+
+    setupSensor(dht22);
+    sensor.setResponse(DHT22Waveform::frame(235, 523, DHT22_WAVEFORM_NO_ACK));
+
+    // No retries without acknowledge, abort after the pulse timeout
+    start = micros();
+    TEST_ASSERT(!dht22.readSensorData());
+    TEST_ASSERT((micros() - start) <
+                (DHT22_START_HIGH_US + DHT22_START_LOW_US + (2 * DHT22_PULSE_TIMEOUT_US)));
+    TEST_ASSERT_EQUAL(DHT22_STATUS_START_ERROR, dht22.getMeasurement().status);
+    TEST_ASSERT_EQUAL(1, dht22.getMeasurement().attempts);
+    TEST_ASSERT_EQUAL(1, sensor.getNumStarts());
+    TEST_ASSERT(mockGetIsr(DHT22_PIN) == NULL);
+
+    // Skipped by the backoff of 2 * DHT22_MIN_READ_INTERVAL
+    delay(DHT22_MIN_READ_INTERVAL);
+    TEST_ASSERT(!dht22.readSensorData());
+    TEST_ASSERT_EQUAL(DHT22_STATUS_START_ERROR, dht22.getMeasurement().status);
+    TEST_ASSERT_EQUAL(0, dht22.getMeasurement().attempts);
+    TEST_ASSERT_EQUAL(1, sensor.getNumStarts());
+
+    // Sensor connected after the backoff
+    delay(DHT22_MIN_READ_INTERVAL);
+    sensor.setData(235, 523);
+    TEST_ASSERT(dht22.readSensorData());
+    TEST_ASSERT_EQUAL(2, sensor.getNumStarts());
+    TEST_ASSERT_EQUAL(235, dht22.readTemperature());
+}
+
+static void testBusError()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+    unsigned long start;
+
+    sensor.setStuckLow(true);
+    setupSensor(dht22);
+
+    // Checked before the start condition
+    start = micros();
+    TEST_ASSERT(!dht22.readSensorData());
+    TEST_ASSERT((micros() - start) < DHT22_START_HIGH_US);
+    TEST_ASSERT_EQUAL(DHT22_STATUS_BUS_ERROR, dht22.getMeasurement().status);
+    TEST_ASSERT_EQUAL(1, dht22.getMeasurement().attempts);
+    TEST_ASSERT_EQUAL(0, sensor.getNumStarts());
+    TEST_ASSERT(mockGetIsr(DHT22_PIN) == NULL);
+}
+
+static void testStaleInterrupt()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+    unsigned long start;
+
+    setupSensor(dht22);
+
+    // The start condition of the next conversion sets the interrupt flag while detached
+    sensor.setData(235, 523);
+    TEST_ASSERT(dht22.readSensorData());
+    delay(DHT22_MIN_READ_INTERVAL);
+
+    // Stale interrupt flag and release edge are no acknowledge: Start error without retries
+    sensor.setResponse(DHT22Waveform::frame(235, 523, DHT22_WAVEFORM_NO_ACK));
+    mockSetPendingInterrupt(DHT22_PIN);
+
+    start = micros();
+    TEST_ASSERT(!dht22.readSensorData());
+    TEST_ASSERT((micros() - start) <
+                (DHT22_START_HIGH_US + DHT22_START_LOW_US + (2 * DHT22_PULSE_TIMEOUT_US)));
+    TEST_ASSERT_EQUAL(DHT22_STATUS_START_ERROR, dht22.getMeasurement().status);
+    TEST_ASSERT_EQUAL(1, dht22.getMeasurement().attempts);
+
+    // Successful conversion with a stale interrupt flag
+    delay(2 * DHT22_MIN_READ_INTERVAL);
+    sensor.setData(-98, 765);
+    mockSetPendingInterrupt(DHT22_PIN);
+
+    TEST_ASSERT(dht22.readSensorData());
+    TEST_ASSERT_EQUAL(1, dht22.getMeasurement().attempts);
+    TEST_ASSERT_EQUAL(-98, dht22.readTemperature());
+    TEST_ASSERT_EQUAL(765, dht22.readHumidity());
+}
+
+static void testRestartCapture()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22Waveform sensor2(DHT22_PIN_2);
+    DHT22 *dht22 = new DHT22(DHT22_PIN);
+    DHT22 dht22b(DHT22_PIN_2);
+
+    if (captureMode == DHT22_CAPTURE_POLLING) {
+        delete dht22;
+        return;
+    }
+
+    setupSensor(*dht22);
+    setupSensor(dht22b);
+    sensor.setData(235, 523);
+    sensor2.setData(-12, 456);
+
+    // Restart during the edge capture releases the interrupt handler
+    dht22->startConversion();
+    while (mockGetIsr(DHT22_PIN) == NULL) {
+        TEST_ASSERT(!dht22->poll());
+    }
+    dht22->startConversion();
+    TEST_ASSERT(mockGetIsr(DHT22_PIN) == NULL);
+    TEST_ASSERT(completeConversion(*dht22));
+    TEST_ASSERT_EQUAL(DHT22_STATUS_OK, dht22->getMeasurement().status);
+
+    // Destroy during the edge capture
+    delay(DHT22_MIN_READ_INTERVAL);
+    dht22->startConversion();
+    while (mockGetIsr(DHT22_PIN) == NULL) {
+        dht22->poll();
+    }
+    delete dht22;
+    TEST_ASSERT(mockGetIsr(DHT22_PIN) == NULL);
+
+    // Another sensor can capture
+    dht22b.startConversion();
+    TEST_ASSERT(completeConversion(dht22b));
+    TEST_ASSERT_EQUAL(-12, dht22b.readTemperature());
+    TEST_ASSERT_EQUAL(456, dht22b.readHumidity());
+}
+
+// Trigger callbacks of testBackgroundTrigger()
+static uint8_t numTriggerCalls;
+static int16_t triggerValue;
+static bool inUpdate;
+
+static DHT22 *triggerSensor;
+
+static void onTrigger(DHT22 *sensor, DHT22Trigger *trigger, int16_t value)
+{
+    (void)trigger;
+
+    TEST_ASSERT(!inUpdate);
+    numTriggerCalls++;
+    triggerValue = value;
+    triggerSensor = sensor;
+}
+
+static void testBackgroundTrigger()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+    DHT22Trigger trigger(DHT22_TRIGGER_ABOVE, DHT22_TRIGGER_TEMPERATURE, 200, 5, onTrigger);
+    uint8_t historyBuffer[64];
+    DHT22History history(historyBuffer, sizeof(historyBuffer));
+    unsigned long start = millis();
+    bool newResult = false;
+
+    setupSensor(dht22);
+    dht22.addTrigger(&trigger);
+    dht22.setHistory(&history);
+    dht22.setAutoSampling(DHT22_MIN_READ_INTERVAL);
+    sensor.setData(235, 523);
+    numTriggerCalls = 0;
+
+    // update() may run in a timer interrupt: No history or callbacks
+    while (!newResult && ((millis() - start) < (2 * DHT22_MIN_READ_INTERVAL))) {
+        inUpdate = true;
+        newResult = dht22.update();
+        inUpdate = false;
+    }
+    TEST_ASSERT(newResult);
+    TEST_ASSERT_EQUAL(0, numTriggerCalls);
+    TEST_ASSERT_EQUAL(0, history.getNumSamples());
+
+    // Processed once by available()
+    TEST_ASSERT(dht22.available());
+    TEST_ASSERT_EQUAL(1, numTriggerCalls);
+    TEST_ASSERT_EQUAL(235, triggerValue);
+    TEST_ASSERT_EQUAL(1, history.getNumSamples());
+    TEST_ASSERT(!dht22.available());
+    TEST_ASSERT_EQUAL(1, numTriggerCalls);
+    TEST_ASSERT_EQUAL(1, history.getNumSamples());
+}
+
+static void testBackgroundFailure()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+    DHT22Trigger change(DHT22_TRIGGER_CHANGE, DHT22_TRIGGER_TEMPERATURE, 0, 0, onTrigger);
+    DHT22Trigger below(DHT22_TRIGGER_BELOW, DHT22_TRIGGER_TEMPERATURE, 100, 5, onTrigger);
+    uint8_t historyBuffer[64];
+    DHT22History history(historyBuffer, sizeof(historyBuffer));
+    DHT22HistorySample sample;
+    unsigned long start = millis();
+    uint32_t timestamp;
+
+    setupSensor(dht22);
+    dht22.setRetries(0);
+    dht22.addTrigger(&change);
+    dht22.addTrigger(&below);
+    dht22.setHistory(&history);
+    dht22.setAutoSampling(DHT22_MIN_READ_INTERVAL);
+    sensor.setData(235, 523);
+    numTriggerCalls = 0;
+
+    while (!dht22.update() && ((millis() - start) < (2 * DHT22_MIN_READ_INTERVAL))) {
+    }
+    TEST_ASSERT_EQUAL(DHT22_STATUS_OK, dht22.getMeasurement().status);
+    timestamp = dht22.getMeasurement().timestamp;
+
+    // Failed conversion before available() is called
+    sensor.setResponse(DHT22Waveform::frame(235, 523, DHT22_WAVEFORM_PARITY));
+    while ((dht22.getMeasurement().status == DHT22_STATUS_OK) &&
+           ((millis() - start) < (4 * DHT22_MIN_READ_INTERVAL))) {
+        dht22.update();
+    }
+    TEST_ASSERT_EQUAL(DHT22_STATUS_PARITY_ERROR, dht22.getMeasurement().status);
+    TEST_ASSERT(dht22.getMeasurement().timestamp != timestamp);
+
+    // Triggers and history use the successful conversion
+    TEST_ASSERT(dht22.available());
+    TEST_ASSERT_EQUAL(1, numTriggerCalls);
+    TEST_ASSERT_EQUAL(235, triggerValue);
+    TEST_ASSERT_EQUAL(1, history.getNumSamples());
+
+    DHT22HistoryIterator iterator(&history);
+    TEST_ASSERT(iterator.next(&sample));
+    TEST_ASSERT_EQUAL(timestamp / 1000, sample.timestamp);
+    TEST_ASSERT_EQUAL(235, sample.temperature);
+    TEST_ASSERT_EQUAL(523, sample.humidity);
+}
+
+static void testTriggerOwner()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+    DHT22 other(DHT22_PIN);
+    DHT22Trigger trigger(DHT22_TRIGGER_CHANGE, DHT22_TRIGGER_TEMPERATURE, 0, 0, onTrigger);
+    DHT22Trigger released(DHT22_TRIGGER_CHANGE, DHT22_TRIGGER_TEMPERATURE, 0, 0, onTrigger);
+
+    dht22.begin();
+    other.begin();
+    numTriggerCalls = 0;
+
+    // A trigger is linked in the list of one sensor only
+    TEST_ASSERT(dht22.addTrigger(&trigger));
+    TEST_ASSERT(dht22.addTrigger(&trigger));
+    TEST_ASSERT(!other.addTrigger(&trigger));
+
+    sensor.setData(100, 500);
+    TEST_ASSERT(other.readSensorData());
+    TEST_ASSERT_EQUAL(0, numTriggerCalls);
+    TEST_ASSERT(dht22.readSensorData());
+    TEST_ASSERT_EQUAL(1, numTriggerCalls);
+    TEST_ASSERT(triggerSensor == &dht22);
+
+    // Moved to the other sensor after removal
+    dht22.removeTrigger(&trigger);
+    TEST_ASSERT(other.addTrigger(&trigger));
+    sensor.setData(200, 500);
+    TEST_ASSERT(dht22.readSensorData());
+    TEST_ASSERT_EQUAL(1, numTriggerCalls);
+    TEST_ASSERT(other.readSensorData());
+    TEST_ASSERT_EQUAL(2, numTriggerCalls);
+    TEST_ASSERT(triggerSensor == &other);
+
+    // Released by the destructor
+    {
+        DHT22 temporary(DHT22_PIN);
+
+        TEST_ASSERT(temporary.addTrigger(&released));
+        TEST_ASSERT(!dht22.addTrigger(&released));
+    }
+    TEST_ASSERT(dht22.addTrigger(&released));
+
+    // Removed from the list of the sensor by the trigger destructor
+    {
+        DHT22Trigger temporary(DHT22_TRIGGER_CHANGE, DHT22_TRIGGER_TEMPERATURE, 0, 0, onTrigger);
+
+        TEST_ASSERT(other.addTrigger(&temporary));
+    }
+    numTriggerCalls = 0;
+    sensor.setData(300, 500);
+    TEST_ASSERT(other.readSensorData());
+    TEST_ASSERT_EQUAL(1, numTriggerCalls);
+    TEST_ASSERT(triggerSensor == &other);
+}
+
+#if DHT22_POWER_CONTROL
+/*!
+ * \brief Power pin changes and start conditions during a conversion
+ */
+typedef struct {
+    //! Timestamp in ms of the last power-off, 0 when not switched off
+    unsigned long powerOff;
+    //! Timestamp in ms of the last power-on, 0 when not switched on
+    unsigned long powerOn;
+    //! Timestamps in ms of the start conditions
+    unsigned long start[4];
+    //! Number of start conditions
+    uint8_t numStarts;
+} PowerEvents;
+
+/*!
+ * \brief Complete a conversion and record the power pin changes and start conditions.
+ */
+static bool convertPowered(DHT22 &dht22, DHT22Waveform &sensor, PowerEvents *events)
+{
+    uint8_t power = mockGetPinOutput(DHT22_POWER_PIN);
+    uint32_t numStarts = sensor.getNumStarts();
+    bool done;
+
+    memset(events, 0, sizeof(PowerEvents));
+
+    dht22.startConversion();
+    do {
+        done = dht22.poll();
+
+        if (mockGetPinOutput(DHT22_POWER_PIN) != power) {
+            power = mockGetPinOutput(DHT22_POWER_PIN);
+            if (power == HIGH) {
+                events->powerOn = millis();
+            } else {
+                events->powerOff = millis();
+            }
+        }
+        if ((sensor.getNumStarts() != numStarts) && (events->numStarts < 4)) {
+            numStarts = sensor.getNumStarts();
+            events->start[events->numStarts++] = millis();
+        }
+    } while (!done);
+
+    return (dht22.getMeasurement().status == DHT22_STATUS_OK);
+}
+
+static void testPowerWarmUp()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+    PowerEvents events;
+    unsigned long powerOff;
+
+    dht22.begin();
+    sensor.setData(235, 523);
+
+    // setPowerPin() switches the sensor off
+    dht22.setPowerPin(DHT22_POWER_PIN, 1000);
+    powerOff = millis();
+    TEST_ASSERT_EQUAL(OUTPUT, mockGetPinMode(DHT22_POWER_PIN));
+    TEST_ASSERT_EQUAL(LOW, mockGetPinOutput(DHT22_POWER_PIN));
+
+    // Minimum power-off time, then the start condition after the warm-up
+    TEST_ASSERT(convertPowered(dht22, sensor, &events));
+    TEST_ASSERT_EQUAL(235, dht22.readTemperature());
+    TEST_ASSERT_EQUAL(1, events.numStarts);
+    TEST_ASSERT((events.powerOn - powerOff) >= DHT22_POWER_OFF_MS);
+    TEST_ASSERT((events.start[0] - events.powerOn) >= 1000);
+    TEST_ASSERT((events.start[0] - events.powerOn) <= (1000 + DHT22_CONVERSION_MAX_MS));
+
+    // Powered sensor: No warm-up
+    delay(DHT22_MIN_READ_INTERVAL);
+    TEST_ASSERT(convertPowered(dht22, sensor, &events));
+    TEST_ASSERT_EQUAL(0, events.powerOn);
+    TEST_ASSERT_EQUAL(1, events.numStarts);
+
+    // powerOff() and the default warm-up
+    dht22.setPowerPin(DHT22_POWER_PIN);
+    delay(DHT22_POWER_OFF_MS);
+    TEST_ASSERT(convertPowered(dht22, sensor, &events));
+    TEST_ASSERT((events.start[0] - events.powerOn) >= DHT22_POWER_WARM_UP_MS);
+}
+
+static void testPowerDiscardFirst()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+    PowerEvents events;
+
+    dht22.begin();
+    dht22.setPowerPin(DHT22_POWER_PIN, 500);
+    dht22.setFirstReadPolicy(DHT22_FIRST_READ_DISCARD);
+
+    // The first conversion after power-on is discarded, the second one is stored
+    sensor.script(DHT22Waveform::frame(111, 222));
+    sensor.setData(235, 523);
+    TEST_ASSERT(convertPowered(dht22, sensor, &events));
+    TEST_ASSERT_EQUAL(2, events.numStarts);
+    TEST_ASSERT((events.start[1] - events.start[0]) >= DHT22_MIN_READ_INTERVAL);
+    TEST_ASSERT_EQUAL(235, dht22.readTemperature());
+    TEST_ASSERT_EQUAL(523, dht22.readHumidity());
+
+    // Not discarded while powered
+    delay(DHT22_MIN_READ_INTERVAL);
+    sensor.setData(-55, 800);
+    TEST_ASSERT(convertPowered(dht22, sensor, &events));
+    TEST_ASSERT_EQUAL(1, events.numStarts);
+    TEST_ASSERT_EQUAL(-55, dht22.readTemperature());
+
+    // A failed discarded conversion does not change the result
+    dht22.powerOff();
+    sensor.script(DHT22Waveform::frame(0, 0, DHT22_WAVEFORM_PARITY));
+    sensor.setData(100, 900);
+    TEST_ASSERT(convertPowered(dht22, sensor, &events));
+    TEST_ASSERT_EQUAL(2, events.numStarts);
+    TEST_ASSERT_EQUAL(100, dht22.readTemperature());
+    TEST_ASSERT_EQUAL(1, dht22.getMeasurement().attempts);
+}
+
+static void testPowerCycle()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+    PowerEvents events;
+
+    dht22.begin();
+    dht22.setRetries(0);
+    dht22.setPowerPin(DHT22_POWER_PIN, 500);
+    dht22.setPowerCycle(2);
+    sensor.setData(235, 523);
+    TEST_ASSERT(convertPowered(dht22, sensor, &events));
+
+    // A successful conversion resets the number of consecutive failures
+    sensor.script(DHT22Waveform::frame(0, 0, DHT22_WAVEFORM_PARITY));
+    sensor.script(DHT22Waveform::frame(235, 523));
+    sensor.script(DHT22Waveform::frame(0, 0, DHT22_WAVEFORM_TRUNCATE, 20));
+    for (uint8_t i = 0; i < 3; i++) {
+        delay(DHT22_MIN_READ_INTERVAL);
+        convertPowered(dht22, sensor, &events);
+        TEST_ASSERT_EQUAL(0, events.powerOff);
+        TEST_ASSERT_EQUAL(HIGH, mockGetPinOutput(DHT22_POWER_PIN));
+    }
+
+    // Second consecutive failure: Power cycle
+    delay(DHT22_MIN_READ_INTERVAL);
+    sensor.script(DHT22Waveform::frame(0, 0, DHT22_WAVEFORM_PARITY));
+    TEST_ASSERT(!convertPowered(dht22, sensor, &events));
+    TEST_ASSERT(events.powerOff != 0);
+    TEST_ASSERT_EQUAL(LOW, mockGetPinOutput(DHT22_POWER_PIN));
+
+    // The next conversion powers the sensor on after the power-off time and warm-up
+    TEST_ASSERT(convertPowered(dht22, sensor, &events));
+    TEST_ASSERT_EQUAL(HIGH, mockGetPinOutput(DHT22_POWER_PIN));
+    TEST_ASSERT(events.powerOn != 0);
+    TEST_ASSERT((events.start[0] - events.powerOn) >= 500);
+    TEST_ASSERT_EQUAL(235, dht22.readTemperature());
+}
+#endif
+
+static void testGpioRegisters()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22Waveform sensorPortB(8);
+    DHT22Waveform sensorNoPort(DHT22_PIN_NO_PORT);
+    DHT22 dht22(DHT22_PIN);
+    DHT22 noPort(DHT22_PIN_NO_PORT);
+    DHT22Pin<DHT22_PIN> fastPin;
+    DHT22Pin<8> fastPinPortB;
+    uint8_t mask = digitalPinToBitMask(DHT22_PIN);
+
+    // Pin 2 is bit 2 of port D, pin 8 bit 0 of port B, pin 40 has no registers
+    TEST_ASSERT(DHT22GpioTraits::fastRead);
+    TEST_ASSERT(DHT22GpioTraits::inputRegister(DHT22_PIN) == &PIND);
+    TEST_ASSERT(DHT22GpioTraits::inputRegister(8) == &PINB);
+    TEST_ASSERT(DHT22GpioTraits::inputRegister(DHT22_PIN_NO_PORT) == NULL);
+    TEST_ASSERT_EQUAL(0x04, mask);
+    TEST_ASSERT_EQUAL(0x01, digitalPinToBitMask(8));
+
+    // The input register follows the bus, the mode and output registers drive it
+    pinMode(DHT22_PIN, INPUT_PULLUP);
+    TEST_ASSERT((PIND & mask) != 0);
+    sensor.setStuckLow(true);
+    TEST_ASSERT((PIND & mask) == 0);
+    TEST_ASSERT((DHT22FastPin<DHT22_PIN>::read()) == 0);
+    sensor.setStuckLow(false);
+    TEST_ASSERT((DHT22FastPin<DHT22_PIN>::read()) != 0);
+
+    *portOutputRegister(PD) &= ~mask;
+    *portModeRegister(PD) |= mask;
+    TEST_ASSERT_EQUAL(OUTPUT, mockGetPinMode(DHT22_PIN));
+    TEST_ASSERT_EQUAL(LOW, mockGetPinOutput(DHT22_PIN));
+    TEST_ASSERT((PIND & mask) == 0);
+    *portModeRegister(PD) &= ~mask;
+    *portOutputRegister(PD) |= mask;
+    TEST_ASSERT_EQUAL(INPUT_PULLUP, mockGetPinMode(DHT22_PIN));
+    TEST_ASSERT((PIND & mask) != 0);
+
+    // Register reads with DHT22GpioTraits and DHT22FastPin, and digitalRead() without registers
+    dht22.begin();
+    noPort.begin();
+    fastPin.begin();
+    fastPinPortB.begin();
+    TEST_ASSERT(dht22.calibrate());
+    TEST_ASSERT(noPort.calibrate());
+    TEST_ASSERT(fastPin.calibrate());
+    TEST_ASSERT(fastPinPortB.calibrate());
+
+    sensor.setData(235, 523);
+    sensorPortB.setData(-55, 800);
+    sensorNoPort.setData(123, 456);
+    TEST_ASSERT(dht22.readSensorData());
+    TEST_ASSERT_EQUAL(235, dht22.readTemperature());
+    TEST_ASSERT(noPort.readSensorData());
+    TEST_ASSERT_EQUAL(123, noPort.readTemperature());
+    TEST_ASSERT_EQUAL(456, noPort.readHumidity());
+    TEST_ASSERT(fastPinPortB.readSensorData());
+    TEST_ASSERT_EQUAL(-55, fastPinPortB.readTemperature());
+    TEST_ASSERT_EQUAL(800, fastPinPortB.readHumidity());
+
+    delay(DHT22_MIN_READ_INTERVAL);
+    sensor.setData(-1, 1000);
+    TEST_ASSERT(fastPin.readSensorData());
+    TEST_ASSERT_EQUAL(-1, fastPin.readTemperature());
+    TEST_ASSERT_EQUAL(1000, fastPin.readHumidity());
+}
+
+static void testCopy()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22T<2> original(DHT22_PIN);
+    DHT22 *allocated = new DHT22(DHT22_PIN);
+    DHT22 assigned(DHT22_PIN_2);
+
+    original.begin();
+    sensor.setData(100, 500);
+    TEST_ASSERT(original.readSensorData());
+    TEST_ASSERT(original.readSensorData());
+
+    // The copy does not use the average window of the original
+    DHT22T<2> copy = original;
+    TEST_ASSERT_EQUAL(100, copy.readTemperature());
+    sensor.setData(300, 500);
+    TEST_ASSERT(copy.readSensorData());
+    TEST_ASSERT_EQUAL(300, copy.readTemperature());
+    sensor.setData(100, 500);
+    TEST_ASSERT(original.readSensorData());
+    TEST_ASSERT_EQUAL(100, original.readTemperature());
+
+    // Average samples allocated by begin() are not shared
+    allocated->begin(4);
+    TEST_ASSERT(allocated->readSensorData());
+    {
+        DHT22 heapCopy(*allocated);
+
+        assigned.begin(4);
+        assigned = *allocated;
+        TEST_ASSERT_EQUAL(100, heapCopy.readTemperature());
+        TEST_ASSERT_EQUAL(100, assigned.readTemperature());
+    }
+    delete allocated;
+
+    // The assigned sensor reads the data pin of the original
+    sensor.setData(200, 500);
+    assigned.begin(4);
+    TEST_ASSERT(assigned.readSensorData());
+    TEST_ASSERT_EQUAL(200, assigned.readTemperature());
+}
+
+static void testAverageStorage()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22T<0> single(DHT22_PIN);
+    DHT22T<2> average(DHT22_PIN);
+
+    // No average state without a window
+    TEST_ASSERT_EQUAL(sizeof(DHT22), sizeof(DHT22T<0>));
+    TEST_ASSERT(sizeof(DHT22T<1>) > sizeof(DHT22));
+
+    single.begin();
+    average.begin();
+    sensor.setData(100, 500);
+    TEST_ASSERT(single.readSensorData());
+    TEST_ASSERT(average.readSensorData());
+    sensor.setData(200, 700);
+    TEST_ASSERT(single.readSensorData());
+    TEST_ASSERT(average.readSensorData());
+    TEST_ASSERT_EQUAL(200, single.readTemperature());
+    TEST_ASSERT_EQUAL(700, single.readHumidity());
+    TEST_ASSERT_EQUAL(150, average.readTemperature());
+    TEST_ASSERT_EQUAL(600, average.readHumidity());
+}
+
+/*!
+ * \brief Read the sensor and check the average.
+ */
+static void readAverage(DHT22 &dht22, DHT22Waveform &sensor, int16_t temperature,
+                        int16_t humidity, int16_t averageTemperature, int16_t averageHumidity)
+{
+    sensor.setData(temperature, humidity);
+    TEST_ASSERT(dht22.readSensorData());
+    TEST_ASSERT_EQUAL(averageTemperature, dht22.readTemperature());
+    TEST_ASSERT_EQUAL(averageHumidity, dht22.readHumidity());
+}
+
+static void testRetainedWindow()
+{
+    static DHT22Retained<4> retained;
+    static DHT22Retained<8> resized;
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+
+    // Power-on: Random memory content is not restored
+    memset(&retained, 0xA5, sizeof(retained));
+    TEST_ASSERT(!dht22.begin(&retained));
+    readAverage(dht22, sensor, 100, 500, 100, 500);
+    readAverage(dht22, sensor, 200, 600, 150, 550);
+
+    // begin() again on the same sensor keeps the window
+    TEST_ASSERT(dht22.begin(&retained));
+    readAverage(dht22, sensor, 300, 700, 200, 600);
+
+    // Wake-up: A new sensor object restores the window
+    {
+        DHT22 wakeUp(DHT22_PIN);
+
+        TEST_ASSERT(wakeUp.begin(&retained));
+        readAverage(wakeUp, sensor, 400, 800, 250, 650);
+        readAverage(wakeUp, sensor, 500, 900, 350, 750);
+    }
+
+    // Corrupted sample, index, count and signature
+    memcpy(&resized, &retained, sizeof(retained));
+    retained.temperatureSamples[1] ^= 0x10;
+    TEST_ASSERT(!dht22.begin(&retained));
+    readAverage(dht22, sensor, 100, 500, 100, 500);
+    TEST_ASSERT(dht22.begin(&retained));
+
+    retained.header.index = 4;
+    TEST_ASSERT(!dht22.begin(&retained));
+    retained.header.count = 5;
+    TEST_ASSERT(!dht22.begin(&retained));
+    retained.header.signature ^= 1;
+    TEST_ASSERT(!dht22.begin(&retained));
+    readAverage(dht22, sensor, 200, 600, 200, 600);
+    TEST_ASSERT(dht22.begin(&retained));
+
+    // Window of another size, for example after a firmware update
+    TEST_ASSERT_EQUAL(DHT22_RETAINED_SIGNATURE, resized.header.signature);
+    TEST_ASSERT_EQUAL(4, resized.header.numSamples);
+    TEST_ASSERT(!dht22.begin(&resized));
+    TEST_ASSERT_EQUAL(8, resized.header.numSamples);
+    readAverage(dht22, sensor, 300, 700, 300, 700);
+    readAverage(dht22, sensor, 100, 500, 200, 600);
+    TEST_ASSERT(dht22.begin(&resized));
+}
+
+int main()
+{
+    static const uint8_t captureModes[] = { DHT22_CAPTURE_POLLING, DHT22_CAPTURE_INTERRUPT };
+
+    for (uint8_t i = 0; i < sizeof(captureModes); i++) {
+        captureMode = captureModes[i];
+        printf("Capture mode %u\n", captureMode);
+
+        TEST_RUN(testSuccess);
+        TEST_RUN(testParityError);
+        TEST_RUN(testTimeout);
+        TEST_RUN(testRetrySpacing);
+        TEST_RUN(testStartError);
+        TEST_RUN(testBusError);
+        TEST_RUN(testStaleInterrupt);
+        TEST_RUN(testRestartCapture);
+        TEST_RUN(testBackgroundTrigger);
+        TEST_RUN(testBackgroundFailure);
+    }
+
+#if DHT22_POWER_CONTROL
+    TEST_RUN(testPowerWarmUp);
+    TEST_RUN(testPowerDiscardFirst);
+    TEST_RUN(testPowerCycle);
+#endif
+    TEST_RUN(testGpioRegisters);
+    TEST_RUN(testCopy);
+    TEST_RUN(testAverageStorage);
+    TEST_RUN(testRetainedWindow);
+    TEST_RUN(testTriggerOwner);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,281 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file DHT22DecodeTest.cpp
+ * \brief Compare the single-pass bit decoders with the two-pass pulse width buffer decoder
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ *
+ *      The polling capture decodes each bit directly after measuring it, and the interrupt capture
+ *      decodes 8-bit saturated pulse widths from a shared ring buffer. Both are compared with the
+ *      previous implementation, which stored all 80 pulse widths in the object and decoded them
+ *      afterwards by comparing the high with the low pulse of each bit. The pulses are recorded
+ *      during the same conversion, so both decoders see identical input.
+ */
+
+#include <ErriezDHT22.h>
+
+#include "DHT22Test.h"
+#include "DHT22Waveform.h"
+
+#define DHT22_PIN       2
+
+//! Number of random frames per capture mode
+#define NUM_FRAMES      250
+
+//! Maximum number of recorded pulses or edges per conversion
+#define MAX_RECORDS     256
+
+/*!
+ * \brief DHT22 which records each measured pulse of the polling capture
+ */
+class DHT22Recorder : public DHT22
+{
+public:
+    explicit DHT22Recorder(uint8_t pin) : DHT22(pin), numPulses(0) { }
+
+    //! Measured pulse widths in loop iterations, 0 on a timeout
+    uint32_t pulses[MAX_RECORDS];
+    //! Level of each measured pulse
+    uint8_t levels[MAX_RECORDS];
+    //! Number of measured pulses
+    uint16_t numPulses;
+
+protected:
+    uint32_t measurePulseWidth(uint8_t level)
+    {
+        uint32_t cycles = DHT22::measurePulseWidth(level);
+
+        if (numPulses < MAX_RECORDS) {
+            pulses[numPulses] = cycles;
+            levels[numPulses] = level;
+            numPulses++;
+        }
+
+        return cycles;
+    }
+};
+
+// Edges recorded in front of the library interrupt handler
+static void (*libraryIsr)(void);
+static unsigned long edgeTimestamps[MAX_RECORDS];
+static bool edgeFalling[MAX_RECORDS];
+static uint16_t numEdges;
+
+static void recordingIsr()
+{
+    if (numEdges < MAX_RECORDS) {
+        edgeTimestamps[numEdges] = micros();
+        edgeFalling[numEdges] = (digitalRead(DHT22_PIN) == LOW);
+        numEdges++;
+    }
+
+    libraryIsr();
+}
+
+// Two-pass decoder of the previous implementation: Store bit when the high pulse is longer than
+// the low pulse
+static bool referenceDecode(const uint32_t *widths, uint8_t *data)
+{
+    memset(data, 0, 5);
+
+    for (int i = 0; i < DHT22_NUM_DATA_BITS; ++i) {
+        uint32_t lowCycles = widths[2 * i];
+        uint32_t highCycles = widths[(2 * i) + 1];
+
+        if ((lowCycles == 0) || (highCycles == 0)) {
+            return false;
+        }
+
+        data[i / 8] <<= 1;
+        if (highCycles > lowCycles) {
+            data[i / 8] |= 1;
+        }
+    }
+
+    return true;
+}
+
+// Expected result of data bytes, as decoded by DHT22
+static void checkResult(DHT22 &dht22, const uint8_t *data)
+{
+    DHT22Measurement measurement = dht22.getMeasurement();
+    uint8_t parity = (uint8_t)(data[0] + data[1] + data[2] + data[3]);
+    int16_t temperature = (int16_t)(((data[2] & 0x7F) << 8) | data[3]);
+
+    if (data[2] & 0x80) {
+        temperature = -temperature;
+    }
+
+    if (parity != data[4]) {
+        TEST_ASSERT_EQUAL(DHT22_STATUS_PARITY_ERROR, measurement.status);
+        return;
+    }
+
+    TEST_ASSERT_EQUAL(DHT22_STATUS_OK, measurement.status);
+    TEST_ASSERT_EQUAL((int16_t)((data[0] << 8) | data[1]), measurement.humidity);
+    TEST_ASSERT_EQUAL(temperature, measurement.temperature);
+}
+
+// Random frame, 1 of 8 with an incorrect parity byte
+static void randomFrame(uint8_t *data)
+{
+    for (uint8_t i = 0; i < 4; i++) {
+        data[i] = (uint8_t)rand();
+    }
+    data[4] = (uint8_t)(data[0] + data[1] + data[2] + data[3]);
+    if ((rand() % 8) == 0) {
+        data[4] ^= (uint8_t)(1 + (rand() % 255));
+    }
+}
+
+// Random timing within the datasheet tolerance
+static DHT22WaveformTiming randomTiming()
+{
+    DHT22WaveformTiming timing;
+
+    timing.responseUs = (uint16_t)(20 + (rand() % 21));
+    timing.ackLowUs = (uint16_t)(75 + (rand() % 11));
+    timing.ackHighUs = (uint16_t)(75 + (rand() % 11));
+    timing.bitLowUs = (uint16_t)(48 + (rand() % 8));
+    timing.zeroHighUs = (uint16_t)(22 + (rand() % 9));
+    timing.oneHighUs = (uint16_t)(68 + (rand() % 8));
+
+    return timing;
+}
+
+static void testPollingDecode()
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22Recorder dht22(DHT22_PIN);
+
+    dht22.begin();
+    dht22.setRetries(0);
+
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        uint8_t data[5];
+        uint8_t reference[5];
+        uint16_t first;
+
+        randomFrame(data);
+        sensor.setResponse(DHT22Waveform::bytes(data));
+        sensor.setTiming(randomTiming());
+
+        dht22.numPulses = 0;
+        dht22.readSensorData();
+
+        // The last 80 measured pulses are the low and high pulses of the data bits
+        TEST_ASSERT(dht22.numPulses >= (DHT22_NUM_DATA_BITS * 2));
+        first = dht22.numPulses - (DHT22_NUM_DATA_BITS * 2);
+        for (uint16_t i = first; i < dht22.numPulses; i++) {
+            TEST_ASSERT_EQUAL(((i - first) % 2) ? HIGH : LOW, dht22.levels[i]);
+        }
+
+        TEST_ASSERT(referenceDecode(&dht22.pulses[first], reference));
+        TEST_ASSERT(memcmp(reference, data, sizeof(data)) == 0);
+        checkResult(dht22, reference);
+    }
+}
+
+static void testInterruptDecode(uint16_t ackHighUs)
+{
+    DHT22Waveform sensor(DHT22_PIN);
+    DHT22 dht22(DHT22_PIN);
+
+    dht22.begin();
+    dht22.setRetries(0);
+    TEST_ASSERT(dht22.setCaptureMode(DHT22_CAPTURE_INTERRUPT));
+
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        DHT22WaveformTiming timing = randomTiming();
+        uint32_t widths[MAX_RECORDS];
+        uint8_t data[5];
+        uint8_t reference[5];
+        uint16_t numWidths = 0;
+        uint32_t lowWidth = 0;
+        uint16_t ack;
+
+        randomFrame(data);
+        sensor.setResponse(DHT22Waveform::bytes(data));
+        if (ackHighUs) {
+            timing.ackHighUs = ackHighUs;
+        }
+        sensor.setTiming(timing);
+
+        // Record the edges in front of the library interrupt handler
+        numEdges = 0;
+        dht22.startConversion();
+        while (mockGetIsr(DHT22_PIN) == NULL) {
+            dht22.poll();
+        }
+        libraryIsr = mockGetIsr(DHT22_PIN);
+        attachInterrupt(digitalPinToInterrupt(DHT22_PIN), recordingIsr, CHANGE);
+        while (!dht22.poll()) {
+        }
+
+        // Pulse width pairs in micro seconds from the acknowledge
+        for (ack = 0; (ack < numEdges) && !edgeFalling[ack]; ack++) {
+        }
+        for (uint16_t i = ack + 1; i < numEdges; i++) {
+            uint32_t width = edgeTimestamps[i] - edgeTimestamps[i - 1];
+
+            if (edgeFalling[i]) {
+                widths[numWidths++] = lowWidth;
+                widths[numWidths++] = width;
+            } else {
+                lowWidth = width;
+            }
+        }
+
+        // Acknowledge and 40 bits, decode the last 40 bits
+        TEST_ASSERT_EQUAL((DHT22_NUM_DATA_BITS + 1) * 2, numWidths);
+        TEST_ASSERT(referenceDecode(&widths[numWidths - (DHT22_NUM_DATA_BITS * 2)], reference));
+        TEST_ASSERT(memcmp(reference, data, sizeof(data)) == 0);
+        checkResult(dht22, reference);
+    }
+}
+
+static void testInterruptDecode()
+{
+    testInterruptDecode(0);
+}
+
+static void testInterruptDecodeSaturated()
+{
+    // Acknowledge high pulse of 300 us is saturated at 255 us in the ring buffer
+    testInterruptDecode(300);
+}
+
+int main()
+{
+    srand(22);
+
+    TEST_RUN(testPollingDecode);
+    TEST_RUN(testInterruptDecode);
+    TEST_RUN(testInterruptDecodeSaturated);
+
+    return TEST_RESULT();
+}
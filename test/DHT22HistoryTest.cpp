@@ -0,0 +1,239 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file DHT22HistoryTest.cpp
+ * \brief Delta-of-delta history round trip, eviction and compression tests
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#include <ErriezDHT22History.h>
+
+#include "DHT22Test.h"
+
+//! Maximum number of samples of a trace
+#define MAX_SAMPLES     4096
+
+//! Trace of added samples
+static DHT22HistorySample trace[MAX_SAMPLES];
+
+/*!
+ * \brief Generate a trace with a constant interval and slowly changing values, like a sensor
+ *        read every minute.
+ */
+static void slowTrace(uint16_t numSamples, uint32_t timestamp)
+{
+    int16_t temperature = 215;
+    int16_t humidity = 450;
+
+    for (uint16_t i = 0; i < numSamples; i++) {
+        // Random walk: Temperature changes 0.1 *C in 1 of 4 samples, humidity 0.1 % in 1 of 2
+        if ((rand() % 4) == 0) {
+            temperature += (rand() & 1) ? 1 : -1;
+        }
+        if ((rand() % 2) == 0) {
+            humidity += (rand() & 1) ? 1 : -1;
+        }
+
+        trace[i].timestamp = timestamp;
+        trace[i].temperature = temperature;
+        trace[i].humidity = humidity;
+        timestamp += 60;
+    }
+}
+
+/*!
+ * \brief Generate a trace with random jumps of all code lengths.
+ */
+static void randomTrace(uint16_t numSamples, uint32_t timestamp)
+{
+    static const int32_t steps[] = { 0, 1, 2, 31, 2047, 30000 };
+
+    for (uint16_t i = 0; i < numSamples; i++) {
+        timestamp += (uint32_t)steps[rand() % 6];
+
+        trace[i].timestamp = timestamp;
+        trace[i].temperature = (int16_t)(rand() % 1601) - 400;
+        trace[i].humidity = (int16_t)(rand() % 1001);
+        if (rand() % 4) {
+            trace[i].temperature = (i > 0) ? trace[i - 1].temperature + (rand() % 3) - 1 : 0;
+        }
+    }
+}
+
+static uint16_t addTrace(DHT22History &history, uint16_t numSamples)
+{
+    for (uint16_t i = 0; i < numSamples; i++) {
+        TEST_ASSERT(history.add(trace[i].timestamp, trace[i].temperature, trace[i].humidity));
+    }
+
+    return history.getNumSamples();
+}
+
+/*!
+ * \brief Check that the history contains the newest samples of the trace.
+ */
+static void checkTrace(DHT22History &history, uint16_t numSamples)
+{
+    DHT22HistoryIterator iterator(&history);
+    DHT22HistorySample sample;
+    uint16_t first = numSamples - history.getNumSamples();
+    uint16_t i;
+
+    for (i = first; iterator.next(&sample); i++) {
+        TEST_ASSERT(i < numSamples);
+        if (i >= numSamples) {
+            return;
+        }
+        TEST_ASSERT_EQUAL(trace[i].timestamp, sample.timestamp);
+        TEST_ASSERT_EQUAL(trace[i].temperature, sample.temperature);
+        TEST_ASSERT_EQUAL(trace[i].humidity, sample.humidity);
+    }
+    TEST_ASSERT_EQUAL(numSamples, i);
+}
+
+static void testRoundTrip()
+{
+    static uint8_t buffer[4096];
+    DHT22History history(buffer, sizeof(buffer));
+
+    // All samples fit
+    randomTrace(500, 1000);
+    TEST_ASSERT_EQUAL(500, addTrace(history, 500));
+    checkTrace(history, 500);
+
+    // Timestamp wraps around
+    history.clear();
+    slowTrace(1000, 0xFFFFFFFFUL - (500 * 60));
+    TEST_ASSERT_EQUAL(1000, addTrace(history, 1000));
+    checkTrace(history, 1000);
+
+    // Extreme values
+    history.clear();
+    trace[0] = { 0, -32768, 0 };
+    trace[1] = { 0xFFFFFFFFUL, 32767, -32768 };
+    trace[2] = { 0, -32768, 32767 };
+    trace[3] = { 0x80000000UL, 0, 0 };
+    TEST_ASSERT_EQUAL(4, addTrace(history, 4));
+    checkTrace(history, 4);
+}
+
+static void testEviction()
+{
+    uint8_t buffer[32];
+    DHT22History history(buffer, sizeof(buffer));
+    uint16_t numSamples = 0;
+
+    // The ring buffer wraps many times, the newest samples are kept
+    randomTrace(2000, 0);
+    for (uint16_t i = 1; i <= 2000; i++) {
+        TEST_ASSERT(history.add(trace[i - 1].timestamp, trace[i - 1].temperature,
+                                trace[i - 1].humidity));
+        TEST_ASSERT(history.getNumBitsUsed() <= (sizeof(buffer) * 8));
+        TEST_ASSERT(history.getNumSamples() >= ((i == 1) ? 1 : 2));
+
+        if ((i % 97) == 0) {
+            checkTrace(history, i);
+        }
+        numSamples = history.getNumSamples();
+    }
+    TEST_ASSERT(numSamples < 2000);
+    checkTrace(history, 2000);
+
+    // Cleared
+    history.clear();
+    TEST_ASSERT_EQUAL(0, history.getNumSamples());
+    TEST_ASSERT_EQUAL(0, history.getNumBitsUsed());
+    DHT22HistoryIterator iterator(&history);
+    DHT22HistorySample sample;
+    TEST_ASSERT(!iterator.next(&sample));
+}
+
+static void testMinimumBuffer()
+{
+    uint8_t buffer[DHT22_HISTORY_MIN_SIZE];
+    uint8_t small[4];
+    DHT22History history(buffer, sizeof(buffer));
+    DHT22History smallHistory(small, sizeof(small));
+    DHT22History noBuffer(NULL, 0);
+
+    // Samples with 36 bit codes for all values fit in the minimum buffer
+    for (uint16_t i = 0; i < 100; i++) {
+        trace[i].timestamp = (i & 1) ? 0x80000000UL : 0;
+        trace[i].temperature = (i & 1) ? 32767 : -32768;
+        trace[i].humidity = (i & 1) ? -32768 : 32767;
+    }
+    addTrace(history, 100);
+    TEST_ASSERT_EQUAL(2, history.getNumSamples());
+    checkTrace(history, 100);
+
+    // A sample which does not fit restarts the history, later samples are still added
+    slowTrace(100, 1000);
+    addTrace(smallHistory, 10);
+    TEST_ASSERT(smallHistory.getNumSamples() > 2);
+    checkTrace(smallHistory, 10);
+
+    TEST_ASSERT(smallHistory.add(0x80000000UL, -400, 1000));
+    TEST_ASSERT_EQUAL(1, smallHistory.getNumSamples());
+    TEST_ASSERT_EQUAL(0, smallHistory.getNumBitsUsed());
+
+    slowTrace(100, 0x80000000UL + 60);
+    addTrace(smallHistory, 100);
+    TEST_ASSERT(smallHistory.getNumSamples() > 2);
+    checkTrace(smallHistory, 100);
+
+    TEST_ASSERT(!noBuffer.add(0, 0, 0));
+    TEST_ASSERT_EQUAL(0, noBuffer.getNumSamples());
+}
+
+static void testCompression()
+{
+    static uint8_t buffer[512];
+    DHT22History history(buffer, sizeof(buffer));
+    // Temperature and humidity in two int16_t arrays without timestamps
+    uint16_t numRaw = sizeof(buffer) / (2 * sizeof(int16_t));
+    uint16_t numSamples;
+
+    slowTrace(MAX_SAMPLES, 0);
+    numSamples = addTrace(history, MAX_SAMPLES);
+    checkTrace(history, MAX_SAMPLES);
+
+    printf("  %u samples in %u Bytes, %.1fx two int16_t arrays (%u samples)\n", numSamples,
+           (unsigned)sizeof(buffer), (double)numSamples / numRaw, numRaw);
+    TEST_ASSERT(numSamples >= (5 * numRaw));
+}
+
+int main()
+{
+    srand(18);
+
+    TEST_RUN(testRoundTrip);
+    TEST_RUN(testEviction);
+    TEST_RUN(testMinimumBuffer);
+    TEST_RUN(testCompression);
+
+    return TEST_RESULT();
+}
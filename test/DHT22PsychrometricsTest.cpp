@@ -0,0 +1,202 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file DHT22PsychrometricsTest.cpp
+ * \brief Accuracy of the integer psychrometrics against a double precision reference
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ *
+ *      Each function is evaluated for every temperature from -40.0 to 80.0 degree Celsius and
+ *      every humidity from 0.0 to 100.0 % in steps of 0.1, the resolution of the sensor.
+ */
+
+#include <math.h>
+
+#include <ErriezDHT22Psychrometrics.h>
+
+#include "DHT22Test.h"
+
+//! Heat index is compared up to 50 degree Celsius, the range of the regression
+#define HEAT_INDEX_MAX_TEMPERATURE  500
+
+//! Magnus formula saturation vapor pressure in Pa
+static double referenceSaturationVaporPressure(double t)
+{
+    return 611.2 * exp((17.62 * t) / (243.12 + t));
+}
+
+static double referenceVaporPressure(double t, double rh)
+{
+    return referenceSaturationVaporPressure(t) * rh / 100.0;
+}
+
+static double referenceDewPoint(double t, double rh)
+{
+    double gamma;
+
+    if (rh <= 0.0) {
+        return DHT22_PSYCHRO_MIN_TEMPERATURE;
+    }
+
+    gamma = log(rh / 100.0) + ((17.62 * t) / (243.12 + t));
+    t = (243.12 * gamma) / (17.62 - gamma);
+
+    return (t < DHT22_PSYCHRO_MIN_TEMPERATURE) ? DHT22_PSYCHRO_MIN_TEMPERATURE : t;
+}
+
+static double referenceAbsoluteHumidity(double t, double rh)
+{
+    return 2.16679 * referenceVaporPressure(t, rh) / (t + 273.15);
+}
+
+// NOAA heat index
+static double referenceHeatIndex(double t, double rh)
+{
+    double f = (t * 1.8) + 32.0;
+    double hi;
+
+    // Simple formula averaged with the temperature
+    hi = (f + (0.5 * (f + 61.0 + ((f - 68.0) * 1.2) + (rh * 0.094)))) / 2.0;
+
+    if (hi >= 80.0) {
+        hi = -42.379 + (2.04901523 * f) + (10.14333127 * rh) - (0.22475541 * f * rh) -
+             (0.00683783 * f * f) - (0.05481717 * rh * rh) + (0.00122874 * f * f * rh) +
+             (0.00085282 * f * rh * rh) - (0.00000199 * f * f * rh * rh);
+
+        if ((rh < 13.0) && (f >= 80.0) && (f <= 112.0)) {
+            hi -= ((13.0 - rh) / 4.0) * sqrt((17.0 - fabs(f - 95.0)) / 17.0);
+        } else if ((rh > 85.0) && (f >= 80.0) && (f <= 87.0)) {
+            hi += ((rh - 85.0) / 10.0) * ((87.0 - f) / 5.0);
+        }
+    }
+
+    return (hi - 32.0) / 1.8;
+}
+
+static double referenceHumidex(double t, double rh)
+{
+    return t + ((5.0 / 9.0) * ((referenceVaporPressure(t, rh) / 100.0) - 10.0));
+}
+
+/*!
+ * \brief Maximum error of a function over the temperature and humidity range
+ */
+typedef struct {
+    const char *name;
+    double maxError;
+    int16_t temperature;
+    int16_t humidity;
+    uint32_t numOutOfTolerance;
+} AccuracyResult;
+
+static void check(AccuracyResult *result, int16_t temperature, int16_t humidity, double value,
+                  double reference, double tolerance)
+{
+    double error = fabs(value - reference);
+
+    if (error > result->maxError) {
+        result->maxError = error;
+        result->temperature = temperature;
+        result->humidity = humidity;
+    }
+    if (error > tolerance) {
+        result->numOutOfTolerance++;
+    }
+}
+
+static void report(AccuracyResult *result)
+{
+    printf("  %-24s max error %.3f at %.1f C, %.1f %%, %u points out of tolerance\n",
+           result->name, result->maxError, result->temperature / 10.0, result->humidity / 10.0,
+           (unsigned)result->numOutOfTolerance);
+    TEST_ASSERT_EQUAL(0, result->numOutOfTolerance);
+}
+
+static void testAccuracy()
+{
+    AccuracyResult vaporPressure = { "Vapor pressure [Pa]", 0, 0, 0, 0 };
+    AccuracyResult dewPoint = { "Dew point [C]", 0, 0, 0, 0 };
+    AccuracyResult absoluteHumidity = { "Absolute humidity [g/m3]", 0, 0, 0, 0 };
+    AccuracyResult heatIndex = { "Heat index [C]", 0, 0, 0, 0 };
+    AccuracyResult humidex = { "Humidex [C]", 0, 0, 0, 0 };
+
+    for (int16_t temperature = DHT22_PSYCHRO_MIN_TEMPERATURE * 10;
+         temperature <= DHT22_PSYCHRO_MAX_TEMPERATURE * 10; temperature++) {
+        for (int16_t humidity = 0; humidity <= 1000; humidity++) {
+            double t = temperature / 10.0;
+            double rh = humidity / 10.0;
+            double es = referenceSaturationVaporPressure(t);
+
+            // Linear interpolation of the 1 degree Celsius table and the 0.1 Pa resolution
+            check(&vaporPressure, temperature, humidity,
+                  DHT22Psychrometrics::vaporPressure(temperature, humidity) / 10.0,
+                  referenceVaporPressure(t, rh), (0.001 * es) + 0.2);
+
+            // Rounded to 0.1 degree Celsius, clamped to -40.0 degree Celsius
+            check(&dewPoint, temperature, humidity,
+                  DHT22Psychrometrics::dewPoint(temperature, humidity) / 10.0,
+                  referenceDewPoint(t, rh), 0.15);
+
+            check(&absoluteHumidity, temperature, humidity,
+                  DHT22Psychrometrics::absoluteHumidity(temperature, humidity) / 10.0,
+                  referenceAbsoluteHumidity(t, rh), 0.1);
+
+            // The regression is evaluated with the temperature rounded to 0.1 F
+            if (temperature <= HEAT_INDEX_MAX_TEMPERATURE) {
+                check(&heatIndex, temperature, humidity,
+                      DHT22Psychrometrics::heatIndex(temperature, humidity) / 10.0,
+                      referenceHeatIndex(t, rh), 0.4);
+            }
+
+            check(&humidex, temperature, humidity,
+                  DHT22Psychrometrics::humidex(temperature, humidity) / 10.0,
+                  referenceHumidex(t, rh), 0.1);
+        }
+    }
+
+    report(&vaporPressure);
+    report(&dewPoint);
+    report(&absoluteHumidity);
+    report(&heatIndex);
+    report(&humidex);
+}
+
+static void testHeatIndexThreshold()
+{
+    // Simple formula average 79.98 F and 79.99975 F: Not the regression (28.5 C)
+    TEST_ASSERT_EQUAL(267, DHT22Psychrometrics::heatIndex(261, 937));
+    TEST_ASSERT_EQUAL(267, DHT22Psychrometrics::heatIndex(261, 945));
+    // Simple formula average 80.02 F: Regression
+    TEST_ASSERT_EQUAL(286, DHT22Psychrometrics::heatIndex(261, 953));
+}
+
+int main()
+{
+    TEST_RUN(testAccuracy);
+    TEST_RUN(testHeatIndexThreshold);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,264 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file DHT22SchedulerTest.cpp
+ * \brief Slot assignment, read interval and capture collision tests of DHT22Scheduler
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ *
+ *      The sweep is polled in a loop which records when each data pin is driven low and released
+ *      in simulated time.
+ */
+
+#include <ErriezDHT22.h>
+#include <ErriezDHT22Scheduler.h>
+
+#include "DHT22Test.h"
+#include "DHT22Waveform.h"
+
+#define NUM_SENSORS     4
+
+//! Data pins
+static const uint8_t pins[NUM_SENSORS] = { 2, 3, 4, 5 };
+
+// Capture mode of the current test
+static uint8_t captureMode;
+
+//! Simulated time in nano seconds when the host drove the data pin low, 0 when not started
+static uint64_t hostLowNs[NUM_SENSORS];
+//! Simulated time in nano seconds when the host released the data pin
+static uint64_t releaseNs[NUM_SENSORS];
+
+/*!
+ * \brief Test fixture: Sensor models, sensors and scheduler
+ */
+struct Fixture
+{
+    DHT22Waveform model0;
+    DHT22Waveform model1;
+    DHT22Waveform model2;
+    DHT22Waveform model3;
+    DHT22 dht22_0;
+    DHT22 dht22_1;
+    DHT22 dht22_2;
+    DHT22 dht22_3;
+    DHT22Waveform *models[NUM_SENSORS];
+    DHT22 *sensors[NUM_SENSORS];
+    DHT22Scheduler scheduler;
+
+    Fixture() :
+            model0(pins[0]), model1(pins[1]), model2(pins[2]), model3(pins[3]),
+            dht22_0(pins[0]), dht22_1(pins[1]), dht22_2(pins[2]), dht22_3(pins[3]),
+            models{ &model0, &model1, &model2, &model3 },
+            sensors{ &dht22_0, &dht22_1, &dht22_2, &dht22_3 },
+            scheduler(sensors, NUM_SENSORS)
+    {
+        for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+            sensors[i]->begin();
+            TEST_ASSERT(sensors[i]->setCaptureMode(captureMode));
+            models[i]->setData(100 + i, 500 + i);
+        }
+    }
+};
+
+//! Sensor index in start order, sensors which were not started are last
+static uint8_t order[NUM_SENSORS];
+
+/*!
+ * \brief Sort the sensors by the start of their start condition.
+ */
+static void sortStartOrder()
+{
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        order[i] = i;
+    }
+
+    for (uint8_t i = 1; i < NUM_SENSORS; i++) {
+        for (uint8_t j = i; j > 0; j--) {
+            uint64_t a = hostLowNs[order[j - 1]] ? hostLowNs[order[j - 1]] : UINT64_MAX;
+            uint64_t b = hostLowNs[order[j]] ? hostLowNs[order[j]] : UINT64_MAX;
+
+            if (a > b) {
+                uint8_t swap = order[j];
+                order[j] = order[j - 1];
+                order[j - 1] = swap;
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Run a sweep and record the start condition of each sensor.
+ * \details
+ *      The scheduler starts the first pending sensor it polls after a slot elapsed, so the start
+ *      order is not the sensor order.
+ * \return Bit mask of successful conversions.
+ */
+static uint16_t sweep(DHT22Scheduler &scheduler)
+{
+    bool done;
+
+    memset(hostLowNs, 0, sizeof(hostLowNs));
+    memset(releaseNs, 0, sizeof(releaseNs));
+
+    scheduler.startSweep();
+    do {
+        done = scheduler.poll();
+
+        for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+            bool low = (mockGetPinMode(pins[i]) == OUTPUT) && (mockGetPinOutput(pins[i]) == LOW);
+
+            if (low && (hostLowNs[i] == 0)) {
+                hostLowNs[i] = mockNs;
+            } else if (!low && (hostLowNs[i] != 0) && (releaseNs[i] == 0)) {
+                releaseNs[i] = mockNs;
+            }
+        }
+    } while (!done);
+
+    sortStartOrder();
+
+    return scheduler.getResult();
+}
+
+static void testSlots()
+{
+    Fixture fixture;
+    uint64_t start = mockNs;
+
+    TEST_ASSERT_EQUAL(0x0F, sweep(fixture.scheduler));
+
+    // One slot per sensor, ~30 ms + N * 5 ms instead of N * 35 ms. The host low phase is recorded
+    // with the resolution of one sweep poll.
+    for (uint8_t i = 1; i < NUM_SENSORS; i++) {
+        uint64_t offsetNs = hostLowNs[order[i]] - hostLowNs[order[i - 1]];
+
+        TEST_ASSERT(offsetNs >= ((DHT22_SCHEDULER_SLOT_US - 20) * 1000ULL));
+        TEST_ASSERT(offsetNs <= ((DHT22_SCHEDULER_SLOT_US + 100) * 1000ULL));
+    }
+    TEST_ASSERT((mockNs - start) <
+                ((DHT22_CONVERSION_MAX_MS + (NUM_SENSORS * DHT22_SCHEDULER_SLOT_US / 1000)) *
+                 1000000ULL));
+
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        TEST_ASSERT_EQUAL(100 + i, fixture.sensors[i]->readTemperature());
+        TEST_ASSERT_EQUAL(500 + i, fixture.sensors[i]->readHumidity());
+        TEST_ASSERT_EQUAL(1, fixture.models[i]->getNumStarts());
+    }
+}
+
+static void testCollision()
+{
+    Fixture fixture;
+    DHT22WaveformTiming timing = DHT22Waveform::defaultTiming;
+
+    // Frames longer than a slot: The data transfers would overlap without collision avoidance
+    timing.bitLowUs = 80;
+    timing.oneHighUs = 90;
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        fixture.models[i]->setTiming(timing);
+    }
+
+    TEST_ASSERT_EQUAL(0x0F, sweep(fixture.scheduler));
+
+    // A sensor is released after the frame of the previously started sensor
+    for (uint8_t i = 1; i < NUM_SENSORS; i++) {
+        TEST_ASSERT(releaseNs[order[i]] >= fixture.models[order[i - 1]]->getFrameEndNs());
+        TEST_ASSERT_EQUAL(1, fixture.models[i]->getNumStarts());
+    }
+    if (captureMode == DHT22_CAPTURE_INTERRUPT) {
+        // The last sensor kept its data pin low while the previous sensor was capturing
+        uint8_t last = order[NUM_SENSORS - 1];
+
+        TEST_ASSERT((releaseNs[last] - hostLowNs[last]) > ((DHT22_START_LOW_US + 500) * 1000ULL));
+    }
+    TEST_ASSERT(mockGetIsr(pins[NUM_SENSORS - 1]) == NULL);
+}
+
+static void testReadInterval()
+{
+    Fixture fixture;
+    uint64_t readNs;
+
+    // Sweeps are DHT22_MIN_READ_INTERVAL apart
+    TEST_ASSERT(!fixture.scheduler.available());
+    while (!fixture.scheduler.isReady()) {
+        fixture.scheduler.poll();
+    }
+    TEST_ASSERT_EQUAL(0x0F, fixture.scheduler.getResult());
+    TEST_ASSERT(!fixture.scheduler.available());
+    TEST_ASSERT(fixture.scheduler.isReady());
+    TEST_ASSERT_EQUAL(1, fixture.model0.getNumStarts());
+
+    // Sensor 1 was read outside the scheduler: It is started DHT22_MIN_READ_INTERVAL after its own
+    // last read, the other sensors are started without waiting
+    delay(DHT22_MIN_READ_INTERVAL);
+    readNs = mockNs;
+    TEST_ASSERT(fixture.dht22_1.readSensorData());
+
+    TEST_ASSERT_EQUAL(0x0F, sweep(fixture.scheduler));
+    TEST_ASSERT((hostLowNs[1] - readNs) >= (DHT22_MIN_READ_INTERVAL * 1000000ULL));
+    TEST_ASSERT((hostLowNs[0] - readNs) < (DHT22_MIN_READ_INTERVAL * 1000000ULL));
+    TEST_ASSERT((hostLowNs[2] - readNs) < (DHT22_MIN_READ_INTERVAL * 1000000ULL));
+    TEST_ASSERT((hostLowNs[3] - readNs) < (DHT22_MIN_READ_INTERVAL * 1000000ULL));
+    TEST_ASSERT_EQUAL(3, fixture.model1.getNumStarts());
+}
+
+static void testBackoff()
+{
+    Fixture fixture;
+
+    // Sensor 1 does not respond
+    fixture.model1.setResponse(DHT22Waveform::frame(0, 0, DHT22_WAVEFORM_NO_ACK));
+    TEST_ASSERT_EQUAL(0x0D, sweep(fixture.scheduler));
+    TEST_ASSERT_EQUAL(DHT22_STATUS_START_ERROR, fixture.dht22_1.getMeasurement().status);
+
+    // Skipped by the backoff without using a slot
+    delay(DHT22_MIN_READ_INTERVAL);
+    TEST_ASSERT_EQUAL(0x0D, sweep(fixture.scheduler));
+    TEST_ASSERT_EQUAL(1, fixture.model1.getNumStarts());
+    TEST_ASSERT_EQUAL(0, hostLowNs[1]);
+    TEST_ASSERT_EQUAL(1, order[NUM_SENSORS - 1]);
+    TEST_ASSERT((hostLowNs[order[2]] - hostLowNs[order[0]]) <=
+                (2 * (DHT22_SCHEDULER_SLOT_US + 100) * 1000ULL));
+}
+
+int main()
+{
+    static const uint8_t captureModes[] = { DHT22_CAPTURE_POLLING, DHT22_CAPTURE_INTERRUPT };
+
+    for (uint8_t i = 0; i < sizeof(captureModes); i++) {
+        captureMode = captureModes[i];
+        printf("Capture mode %u\n", captureMode);
+
+        TEST_RUN(testSlots);
+        TEST_RUN(testCollision);
+        TEST_RUN(testReadInterval);
+        TEST_RUN(testBackoff);
+    }
+
+    return TEST_RESULT();
+}
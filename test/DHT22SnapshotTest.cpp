@@ -0,0 +1,185 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file DHT22SnapshotTest.cpp
+ * \brief Multithreaded stress test of getSnapshot()
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ *
+ *      One writer thread publishes conversion results with publishSnapshot() as fast as possible,
+ *      while reader threads call getSnapshot(). Temperature and humidity are derived from the
+ *      timestamp of each conversion, so a snapshot mixing two conversions is detected. Only the
+ *      writer uses the mock HAL, which is not thread safe.
+ */
+
+#include <ErriezDHT22.h>
+
+#include <atomic>
+#include <thread>
+
+#include "DHT22Test.h"
+
+#define DHT22_PIN       2
+
+//! Number of reader threads
+#define NUM_READERS     3
+//! Number of published conversions
+#define NUM_CONVERSIONS 2000000UL
+
+/*!
+ * \brief Access to the conversion result of a DHT22 object
+ */
+class DHT22TestAccess
+{
+public:
+    /*!
+     * \brief Store a successful conversion result and publish it, like finishConversion().
+     */
+    static void publish(DHT22 &dht22, uint32_t timestamp, int16_t temperature, int16_t humidity)
+    {
+        dht22._status = DHT22_STATUS_OK;
+        dht22._numAttempts = 1;
+        dht22._lastMeasurementTimestamp = timestamp;
+        dht22._temperature = temperature;
+        dht22._humidity = humidity;
+
+        dht22.publishSnapshot();
+    }
+
+    /*!
+     * \brief Copy a snapshot buffer without the sequence counter.
+     */
+    static DHT22Measurement readUnlocked(DHT22 &dht22)
+    {
+        return dht22._snapshots[0];
+    }
+};
+
+static DHT22 dht22(DHT22_PIN);
+static std::atomic<bool> stop(false);
+
+// Conversion result from a timestamp, all fields differ for consecutive conversions
+static int16_t temperatureOf(uint32_t timestamp)
+{
+    return (int16_t)((timestamp % 1250) - 400);
+}
+
+static int16_t humidityOf(uint32_t timestamp)
+{
+    return (int16_t)((timestamp * 7) % 1001);
+}
+
+static bool consistent(const DHT22Measurement &measurement)
+{
+    return (measurement.status == DHT22_STATUS_OK) && (measurement.attempts == 1) &&
+           (measurement.temperature == temperatureOf(measurement.timestamp)) &&
+           (measurement.humidity == humidityOf(measurement.timestamp));
+}
+
+static void writer()
+{
+    for (uint32_t timestamp = 1; timestamp <= NUM_CONVERSIONS; timestamp++) {
+        DHT22TestAccess::publish(dht22, timestamp, temperatureOf(timestamp),
+                                 humidityOf(timestamp));
+    }
+
+    stop = true;
+}
+
+static void reader(unsigned long *numReads, unsigned long *numTorn, unsigned long *numOld)
+{
+    uint32_t lastTimestamp = 0;
+
+    while (!stop) {
+        DHT22Measurement measurement = dht22.getSnapshot();
+
+        if (!consistent(measurement)) {
+            (*numTorn)++;
+        }
+
+        // Snapshots are never older than a previous snapshot
+        if (measurement.timestamp < lastTimestamp) {
+            (*numOld)++;
+        }
+        lastTimestamp = measurement.timestamp;
+        (*numReads)++;
+    }
+}
+
+static void unlockedReader(unsigned long *numReads, unsigned long *numTorn)
+{
+    while (!stop) {
+        if (!consistent(DHT22TestAccess::readUnlocked(dht22))) {
+            (*numTorn)++;
+        }
+        (*numReads)++;
+    }
+}
+
+static void testSnapshotStress()
+{
+    std::thread readers[NUM_READERS];
+    unsigned long numReads[NUM_READERS] = { 0 };
+    unsigned long numTorn[NUM_READERS] = { 0 };
+    unsigned long numOld[NUM_READERS] = { 0 };
+    unsigned long numUnlockedReads = 0;
+    unsigned long numUnlockedTorn = 0;
+
+    dht22.begin();
+    DHT22TestAccess::publish(dht22, 0, temperatureOf(0), humidityOf(0));
+
+    for (int i = 0; i < NUM_READERS; i++) {
+        readers[i] = std::thread(reader, &numReads[i], &numTorn[i], &numOld[i]);
+    }
+    std::thread control(unlockedReader, &numUnlockedReads, &numUnlockedTorn);
+    std::thread publisher(writer);
+
+    publisher.join();
+    control.join();
+    for (int i = 0; i < NUM_READERS; i++) {
+        readers[i].join();
+
+        printf("  Reader %d: %lu reads, %lu torn, %lu old\n", i, numReads[i], numTorn[i],
+               numOld[i]);
+        TEST_ASSERT(numReads[i] > 0);
+        TEST_ASSERT_EQUAL(0, numTorn[i]);
+        TEST_ASSERT_EQUAL(0, numOld[i]);
+    }
+
+    // Without the sequence counter, reads overlapping a write are torn. Informational only: This
+    // depends on the number of CPU cores.
+    printf("  Unlocked reader: %lu reads, %lu torn\n", numUnlockedReads, numUnlockedTorn);
+
+    TEST_ASSERT(consistent(dht22.getSnapshot()));
+    TEST_ASSERT_EQUAL(NUM_CONVERSIONS, dht22.getSnapshot().timestamp);
+}
+
+int main()
+{
+    TEST_RUN(testSnapshotStress);
+
+    return TEST_RESULT();
+}
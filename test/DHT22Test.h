@@ -0,0 +1,74 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file DHT22Test.h
+ * \brief Minimal test assertions for the host tests
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#ifndef DHT22_TEST_H_
+#define DHT22_TEST_H_
+
+#include <Arduino.h>
+
+//! Number of failed assertions
+static int testNumFailures;
+
+//! Check a condition
+#define TEST_ASSERT(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            testNumFailures++; \
+        } \
+    } while (0)
+
+//! Check an integer value
+#define TEST_ASSERT_EQUAL(expected, actual) \
+    do { \
+        long long _expected = (long long)(expected); \
+        long long _actual = (long long)(actual); \
+        if (_expected != _actual) { \
+            printf("%s:%d: FAILED: %s == %s (%lld != %lld)\n", __FILE__, __LINE__, #expected, \
+                   #actual, _expected, _actual); \
+            testNumFailures++; \
+        } \
+    } while (0)
+
+//! Run a test function with reset mock pins and interrupts
+#define TEST_RUN(function) \
+    do { \
+        printf("%s\n", #function); \
+        mockReset(); \
+        function(); \
+    } while (0)
+
+//! Test program exit code
+#define TEST_RESULT() \
+    ((testNumFailures == 0) ? (printf("OK\n"), 0) : (printf("%d FAILED\n", testNumFailures), 1))
+
+#endif // DHT22_TEST_H_
@@ -0,0 +1,358 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file DHT22Waveform.cpp
+ * \brief Scripted DHT22 sensor model for the host tests
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#include "DHT22Waveform.h"
+
+//! Minimum start condition low time detected by the sensor in nano seconds
+#define DHT22_WAVEFORM_START_LOW_NS     1000000ULL
+
+// Datasheet timing: 20..40 us response, 80 us acknowledge, 50 us bit low, 26..28 or 70 us high
+const DHT22WaveformTiming DHT22Waveform::defaultTiming = { 30, 80, 80, 50, 27, 70 };
+
+/*!
+ * \brief Constructor. Connects the sensor to a mock pin.
+ * \param pin
+ *      Data pin.
+ */
+DHT22Waveform::DHT22Waveform(uint8_t pin) :
+    _pin(pin), _timing(defaultTiming), _scriptHead(0), _scriptCount(0), _stuckLow(false),
+    _active(false), _hostLowNs(0), _releaseNs(0), _frameNs(0), _numStarts(0), _lastStartLowUs(0)
+{
+    _default = frame(0, 0);
+    _response = _default;
+
+    mockConnect(_pin, this);
+}
+
+/*!
+ * \brief Destructor. Disconnects the sensor.
+ */
+DHT22Waveform::~DHT22Waveform()
+{
+    mockConnect(_pin, NULL);
+}
+
+/*!
+ * \brief Create a response from temperature and humidity.
+ * \param temperature
+ *      Temperature with last digit after the point.
+ * \param humidity
+ *      Humidity with last digit after the point.
+ * \param fault
+ *      DHT22_WAVEFORM_OK, DHT22_WAVEFORM_NO_ACK, DHT22_WAVEFORM_TRUNCATE or DHT22_WAVEFORM_PARITY.
+ * \param numBits
+ *      Number of data bits of a truncated response.
+ * \return
+ *      Response.
+ */
+DHT22WaveformResponse DHT22Waveform::frame(int16_t temperature, int16_t humidity, uint8_t fault,
+                                           uint8_t numBits)
+{
+    DHT22WaveformResponse response;
+    uint16_t rawTemperature;
+
+    // Sign and magnitude temperature
+    rawTemperature = (temperature < 0) ? (0x8000 | (uint16_t)(-temperature)) :
+                                         (uint16_t)temperature;
+
+    response.data[0] = (uint8_t)((uint16_t)humidity >> 8);
+    response.data[1] = (uint8_t)humidity;
+    response.data[2] = (uint8_t)(rawTemperature >> 8);
+    response.data[3] = (uint8_t)rawTemperature;
+    response.data[4] = (uint8_t)(response.data[0] + response.data[1] + response.data[2] +
+                                 response.data[3]);
+    if (fault == DHT22_WAVEFORM_PARITY) {
+        response.data[4] ^= 0x01;
+    }
+    response.fault = fault;
+    response.numBits = numBits;
+
+    return response;
+}
+
+/*!
+ * \brief Create a response from raw data bytes.
+ * \param data
+ *      5 Bytes, including the parity byte.
+ * \return
+ *      Response.
+ */
+DHT22WaveformResponse DHT22Waveform::bytes(const uint8_t *data)
+{
+    DHT22WaveformResponse response;
+
+    memcpy(response.data, data, sizeof(response.data));
+    response.fault = DHT22_WAVEFORM_OK;
+    response.numBits = 0;
+
+    return response;
+}
+
+/*!
+ * \brief Set the response when the script is empty.
+ * \param response
+ *      Response.
+ */
+void DHT22Waveform::setResponse(const DHT22WaveformResponse &response)
+{
+    _default = response;
+}
+
+/*!
+ * \brief Set a successful default response.
+ * \param temperature
+ *      Temperature with last digit after the point.
+ * \param humidity
+ *      Humidity with last digit after the point.
+ */
+void DHT22Waveform::setData(int16_t temperature, int16_t humidity)
+{
+    _default = frame(temperature, humidity);
+}
+
+/*!
+ * \brief Set response timing.
+ * \param timing
+ *      Timing in micro seconds.
+ */
+void DHT22Waveform::setTiming(const DHT22WaveformTiming &timing)
+{
+    _timing = timing;
+}
+
+/*!
+ * \brief Short-circuit the data pin to GND.
+ * \param stuckLow
+ *      true: Data pin low, false: Normal operation.
+ */
+void DHT22Waveform::setStuckLow(bool stuckLow)
+{
+    _stuckLow = stuckLow;
+}
+
+/*!
+ * \brief Append a response to the script.
+ * \param response
+ *      Response to the next start condition.
+ * \retval true
+ *      Response added.
+ * \retval false
+ *      Script full.
+ */
+bool DHT22Waveform::script(const DHT22WaveformResponse &response)
+{
+    if (_scriptCount >= DHT22_WAVEFORM_MAX_SCRIPT) {
+        return false;
+    }
+
+    _script[(_scriptHead + _scriptCount) % DHT22_WAVEFORM_MAX_SCRIPT] = response;
+    _scriptCount++;
+
+    return true;
+}
+
+/*!
+ * \brief Remove all scripted responses.
+ */
+void DHT22Waveform::clearScript()
+{
+    _scriptHead = 0;
+    _scriptCount = 0;
+}
+
+/*!
+ * \brief Get the number of detected start conditions.
+ * \return
+ *      Number of start conditions.
+ */
+uint32_t DHT22Waveform::getNumStarts()
+{
+    return _numStarts;
+}
+
+/*!
+ * \brief Get the low time of the last start condition.
+ * \return
+ *      Low time in micro seconds.
+ */
+uint32_t DHT22Waveform::getLastStartLowUs()
+{
+    return _lastStartLowUs;
+}
+
+/*!
+ * \brief Get the end of the last response.
+ * \return
+ *      Simulated time in nano seconds when the sensor released the data pin after the last bit.
+ */
+uint64_t DHT22Waveform::getFrameEndNs()
+{
+    return _releaseNs + _frameNs;
+}
+
+/*!
+ * \brief Get the data pin.
+ * \return
+ *      Data pin.
+ */
+uint8_t DHT22Waveform::getPin()
+{
+    return _pin;
+}
+
+/*!
+ * \brief Get the level driven by the sensor.
+ * \param ns
+ *      Simulated time in nano seconds.
+ * \return
+ *      LOW: Sensor pulls the data pin low, HIGH: Sensor releases the data pin.
+ */
+uint8_t DHT22Waveform::level(uint64_t ns)
+{
+    uint64_t t;
+    uint8_t numBits;
+
+    if (_stuckLow) {
+        return LOW;
+    }
+    if (!_active || (ns < _releaseNs)) {
+        return HIGH;
+    }
+    if (ns >= (_releaseNs + _frameNs)) {
+        // End of the response
+        _active = false;
+        return HIGH;
+    }
+
+    t = ns - _releaseNs;
+
+    // Response delay and acknowledge
+    if (t < (_timing.responseUs * 1000ULL)) {
+        return HIGH;
+    }
+    t -= _timing.responseUs * 1000ULL;
+    if (t < (_timing.ackLowUs * 1000ULL)) {
+        return LOW;
+    }
+    t -= _timing.ackLowUs * 1000ULL;
+    if (t < (_timing.ackHighUs * 1000ULL)) {
+        return HIGH;
+    }
+    t -= _timing.ackHighUs * 1000ULL;
+
+    // Data bits
+    numBits = (_response.fault == DHT22_WAVEFORM_TRUNCATE) ? _response.numBits : 40;
+    for (uint8_t i = 0; i < numBits; i++) {
+        bool one = (_response.data[i / 8] & (0x80 >> (i % 8))) != 0;
+        uint64_t highNs = (one ? _timing.oneHighUs : _timing.zeroHighUs) * 1000ULL;
+
+        if (t < (_timing.bitLowUs * 1000ULL)) {
+            return LOW;
+        }
+        t -= _timing.bitLowUs * 1000ULL;
+        if (t < highNs) {
+            return HIGH;
+        }
+        t -= highNs;
+    }
+
+    // End of the last bit, a truncated response stays high
+    if ((numBits == 40) && (t < (_timing.bitLowUs * 1000ULL))) {
+        return LOW;
+    }
+
+    return HIGH;
+}
+
+/*!
+ * \brief Detect the start condition.
+ * \param low
+ *      true: Host drives the data pin low, false: Host releases the data pin.
+ * \param ns
+ *      Simulated time in nano seconds.
+ */
+void DHT22Waveform::hostDrive(bool low, uint64_t ns)
+{
+    if (low) {
+        // Host aborts a response in progress
+        _active = false;
+        _hostLowNs = ns;
+        return;
+    }
+
+    if ((ns - _hostLowNs) < DHT22_WAVEFORM_START_LOW_NS) {
+        return;
+    }
+
+    _numStarts++;
+    _lastStartLowUs = (uint32_t)((ns - _hostLowNs) / 1000ULL);
+
+    if (_scriptCount > 0) {
+        _response = _script[_scriptHead];
+        _scriptHead = (_scriptHead + 1) % DHT22_WAVEFORM_MAX_SCRIPT;
+        _scriptCount--;
+    } else {
+        _response = _default;
+    }
+
+    _active = true;
+    _releaseNs = ns;
+    _frameNs = frameNs();
+}
+
+/*!
+ * \brief Calculate the duration of the current response.
+ * \return
+ *      Duration in nano seconds from the release of the data pin.
+ */
+uint64_t DHT22Waveform::frameNs()
+{
+    uint64_t us = _timing.responseUs;
+    uint8_t numBits;
+
+    if (_response.fault == DHT22_WAVEFORM_NO_ACK) {
+        return 0;
+    }
+
+    us += _timing.ackLowUs + _timing.ackHighUs;
+    numBits = (_response.fault == DHT22_WAVEFORM_TRUNCATE) ? _response.numBits : 40;
+    for (uint8_t i = 0; i < numBits; i++) {
+        bool one = (_response.data[i / 8] & (0x80 >> (i % 8))) != 0;
+
+        us += _timing.bitLowUs + (one ? _timing.oneHighUs : _timing.zeroHighUs);
+    }
+    if (numBits == 40) {
+        us += _timing.bitLowUs;
+    }
+
+    return us * 1000ULL;
+}
@@ -0,0 +1,135 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file DHT22Waveform.h
+ * \brief Scripted DHT22 sensor model for the host tests
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#ifndef DHT22_WAVEFORM_H_
+#define DHT22_WAVEFORM_H_
+
+#include <Arduino.h>
+
+//! Response: Acknowledge, 40 data bits and correct parity
+#define DHT22_WAVEFORM_OK           0
+//! Response: No acknowledge, the data pin stays high (sensor absent)
+#define DHT22_WAVEFORM_NO_ACK       1
+//! Response: Acknowledge, followed by numBits data bits, the data pin stays high
+#define DHT22_WAVEFORM_TRUNCATE     2
+//! Response: Acknowledge and 40 data bits with an incorrect parity byte
+#define DHT22_WAVEFORM_PARITY       3
+
+//! Maximum number of scripted responses
+#define DHT22_WAVEFORM_MAX_SCRIPT   16
+
+/*!
+ * \brief Sensor response timing in micro seconds
+ */
+typedef struct {
+    //! Data pin high after the host releases the data pin
+    uint16_t responseUs;
+    //! Acknowledge low
+    uint16_t ackLowUs;
+    //! Acknowledge high
+    uint16_t ackHighUs;
+    //! Low pulse of each data bit and after the last bit
+    uint16_t bitLowUs;
+    //! High pulse of a 0 bit
+    uint16_t zeroHighUs;
+    //! High pulse of a 1 bit
+    uint16_t oneHighUs;
+} DHT22WaveformTiming;
+
+/*!
+ * \brief Sensor response to one start condition
+ */
+typedef struct {
+    //! Humidity high, humidity low, temperature high, temperature low and parity
+    uint8_t data[5];
+    //! DHT22_WAVEFORM_OK, DHT22_WAVEFORM_NO_ACK, DHT22_WAVEFORM_TRUNCATE or DHT22_WAVEFORM_PARITY
+    uint8_t fault;
+    //! Number of data bits of a truncated response
+    uint8_t numBits;
+} DHT22WaveformResponse;
+
+/*!
+ * \brief DHT22 sensor model connected to a mock Arduino pin
+ * \details
+ *      A start condition is detected when the host releases the data pin after driving it low for
+ *      at least 1 ms. The sensor then generates the next scripted response, or the default
+ *      response when the script is empty. The data pin is low when the bus is stuck low.
+ */
+class DHT22Waveform : public MockPinDevice
+{
+public:
+    explicit DHT22Waveform(uint8_t pin);
+    ~DHT22Waveform();
+
+    static DHT22WaveformResponse frame(int16_t temperature, int16_t humidity,
+                                       uint8_t fault = DHT22_WAVEFORM_OK, uint8_t numBits = 0);
+    static DHT22WaveformResponse bytes(const uint8_t *data);
+
+    void setResponse(const DHT22WaveformResponse &response);
+    void setData(int16_t temperature, int16_t humidity);
+    void setTiming(const DHT22WaveformTiming &timing);
+    void setStuckLow(bool stuckLow);
+    bool script(const DHT22WaveformResponse &response);
+    void clearScript();
+
+    uint32_t getNumStarts();
+    uint32_t getLastStartLowUs();
+    uint64_t getFrameEndNs();
+    uint8_t getPin();
+
+    uint8_t level(uint64_t ns);
+    void hostDrive(bool low, uint64_t ns);
+
+    //! Nominal sensor timing
+    static const DHT22WaveformTiming defaultTiming;
+
+private:
+    uint8_t _pin;
+    DHT22WaveformTiming _timing;
+    DHT22WaveformResponse _default;
+    DHT22WaveformResponse _script[DHT22_WAVEFORM_MAX_SCRIPT];
+    uint8_t _scriptHead;
+    uint8_t _scriptCount;
+    bool _stuckLow;
+
+    bool _active;
+    DHT22WaveformResponse _response;
+    uint64_t _hostLowNs;
+    uint64_t _releaseNs;
+    uint64_t _frameNs;
+    uint32_t _numStarts;
+    uint32_t _lastStartLowUs;
+
+    uint64_t frameNs();
+};
+
+#endif // DHT22_WAVEFORM_H_
@@ -0,0 +1,394 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file Arduino.cpp
+ * \brief Mock Arduino HAL to build and test the DHT22 library on a Linux host
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ */
+
+#include <Arduino.h>
+
+MockSerial Serial;
+
+// Start at 1 second, so timestamps of the first conversion are not 0
+uint64_t mockNs = 1000000000ULL;
+uint32_t mockCallNs = 250;
+uint32_t mockIsrLatencyNs = 2000;
+uint64_t mockNumCalls;
+
+static uint8_t _pinMode[MOCK_NUM_PINS];
+static uint8_t _pinOutput[MOCK_NUM_PINS];
+static MockPinDevice *_devices[MOCK_NUM_PINS];
+
+static void (*_isr[MOCK_NUM_PINS])(void);
+static int _isrMode[MOCK_NUM_PINS];
+static uint8_t _isrLevel[MOCK_NUM_PINS];
+static bool _isrPending[MOCK_NUM_PINS];
+static uint64_t _isrPins;
+static bool _interruptsEnabled = true;
+static bool _inIsr;
+
+static bool hostDrivesLow(uint8_t pin)
+{
+    return (_pinMode[pin] == OUTPUT) && (_pinOutput[pin] == LOW);
+}
+
+static uint8_t busLevel(uint8_t pin)
+{
+    // Open drain bus with pull-up: Low when the host or the device pulls it low
+    if (_pinMode[pin] == OUTPUT) {
+        return _pinOutput[pin];
+    }
+    if ((_devices[pin] != NULL) && (_devices[pin]->level(mockNs) == LOW)) {
+        return LOW;
+    }
+
+    return HIGH;
+}
+
+static void setPin(uint8_t pin, uint8_t mode, uint8_t output)
+{
+    bool low = hostDrivesLow(pin);
+
+    _pinMode[pin] = mode;
+    _pinOutput[pin] = output;
+
+    if ((_devices[pin] != NULL) && (hostDrivesLow(pin) != low)) {
+        _devices[pin]->hostDrive(!low, mockNs);
+    }
+}
+
+void mockTick(uint64_t ns)
+{
+    mockNs += ns;
+    mockNumCalls++;
+
+    if (!_interruptsEnabled || _inIsr) {
+        return;
+    }
+
+    // Only pins with an interrupt mode set the interrupt flag
+    for (uint64_t pins = _isrPins; pins != 0; pins &= (pins - 1)) {
+        uint8_t pin = (uint8_t)__builtin_ctzll(pins);
+        uint8_t level = busLevel(pin);
+
+        if (level != _isrLevel[pin]) {
+            _isrLevel[pin] = level;
+            if ((_isrMode[pin] == CHANGE) || ((_isrMode[pin] == FALLING) && (level == LOW)) ||
+                ((_isrMode[pin] == RISING) && (level == HIGH))) {
+                _isrPending[pin] = true;
+            }
+        }
+
+        if ((_isr[pin] != NULL) && _isrPending[pin]) {
+            _isrPending[pin] = false;
+            _inIsr = true;
+            mockNs += mockIsrLatencyNs;
+            _isr[pin]();
+            _inIsr = false;
+        }
+    }
+}
+
+bool mockInIsr()
+{
+    return _inIsr;
+}
+
+void (*mockGetIsr(uint8_t pin))(void)
+{
+    return _isr[pin];
+}
+
+void mockSetPendingInterrupt(uint8_t pin)
+{
+    _isrPending[pin] = true;
+}
+
+uint8_t mockGetPinMode(uint8_t pin)
+{
+    return _pinMode[pin];
+}
+
+uint8_t mockGetPinOutput(uint8_t pin)
+{
+    return _pinOutput[pin];
+}
+
+void mockConnect(uint8_t pin, MockPinDevice *device)
+{
+    _devices[pin] = device;
+    _isrLevel[pin] = busLevel(pin);
+}
+
+void mockReset()
+{
+    for (uint8_t pin = 0; pin < MOCK_NUM_PINS; pin++) {
+        _pinMode[pin] = INPUT;
+        _pinOutput[pin] = LOW;
+        _isr[pin] = NULL;
+        _isrMode[pin] = 0;
+        _isrPending[pin] = false;
+        _isrLevel[pin] = busLevel(pin);
+    }
+    _isrPins = 0;
+    _interruptsEnabled = true;
+    mockNumCalls = 0;
+}
+
+unsigned long millis()
+{
+    mockTick(mockCallNs);
+    return (unsigned long)(mockNs / 1000000ULL);
+}
+
+unsigned long micros()
+{
+    mockTick(mockCallNs);
+    return (unsigned long)(mockNs / 1000ULL);
+}
+
+static bool isrAttached()
+{
+    for (uint8_t pin = 0; pin < MOCK_NUM_PINS; pin++) {
+        if (_isr[pin] != NULL) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void advance(uint64_t ns)
+{
+    // Advance in steps of 1 us while an interrupt handler is attached, so edges are dispatched in
+    // time
+    if (!isrAttached()) {
+        mockTick(ns);
+        return;
+    }
+
+    for (uint64_t i = 0; i < ns; i += 1000) {
+        mockTick(1000);
+    }
+}
+
+void delay(unsigned long ms)
+{
+    advance(ms * 1000000ULL);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    advance(us * 1000ULL);
+}
+
+void yield()
+{
+    mockTick(mockCallNs);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    mockTick(mockCallNs);
+
+    // The output register enables or disables the pull-up, like AVR targets
+    if (mode == INPUT_PULLUP) {
+        setPin(pin, mode, HIGH);
+    } else if (mode == INPUT) {
+        setPin(pin, mode, LOW);
+    } else {
+        setPin(pin, mode, _pinOutput[pin]);
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    mockTick(mockCallNs);
+    setPin(pin, _pinMode[pin], value ? HIGH : LOW);
+}
+
+int digitalRead(uint8_t pin)
+{
+    mockTick(mockCallNs);
+    return busLevel(pin);
+}
+
+void noInterrupts()
+{
+    _interruptsEnabled = false;
+}
+
+void interrupts()
+{
+    _interruptsEnabled = true;
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*isr)(void), int mode)
+{
+    // A pending interrupt flag is not cleared, like the AVR INTFx flags
+    _isrMode[interruptNum] = mode;
+    _isrPins |= (1ULL << interruptNum);
+    _isrLevel[interruptNum] = busLevel(interruptNum);
+    _isr[interruptNum] = isr;
+}
+
+void detachInterrupt(uint8_t interruptNum)
+{
+    // Edges still set the interrupt flag, like the AVR external interrupts
+    _isr[interruptNum] = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+// IO port registers
+//--------------------------------------------------------------------------------------------------
+//! Input, data direction and output registers of port B, C and D
+static volatile MockRegister _registers[3][3] = {
+    { MockRegister(PB, MOCK_REG_PIN), MockRegister(PB, MOCK_REG_DDR),
+      MockRegister(PB, MOCK_REG_PORT) },
+    { MockRegister(PC, MOCK_REG_PIN), MockRegister(PC, MOCK_REG_DDR),
+      MockRegister(PC, MOCK_REG_PORT) },
+    { MockRegister(PD, MOCK_REG_PIN), MockRegister(PD, MOCK_REG_DDR),
+      MockRegister(PD, MOCK_REG_PORT) },
+};
+
+volatile MockRegister TCNT0(NOT_A_PORT, MOCK_REG_TCNT0);
+
+//! First Arduino pin of port B, C and D
+static const uint8_t _portFirstPin[3] = { 8, 14, 0 };
+//! Number of Arduino pins of port B, C and D
+static const uint8_t _portNumPins[3] = { 6, 6, 8 };
+
+uint8_t digitalPinToPort(uint8_t pin)
+{
+    if (pin < 8) {
+        return PD;
+    } else if (pin < 14) {
+        return PB;
+    } else if (pin < 20) {
+        return PC;
+    }
+
+    return NOT_A_PORT;
+}
+
+uint8_t digitalPinToBitMask(uint8_t pin)
+{
+    uint8_t port = digitalPinToPort(pin);
+
+    if (port == NOT_A_PORT) {
+        return 0;
+    }
+
+    return 1 << (pin - _portFirstPin[port - PB]);
+}
+
+volatile MockRegister *portInputRegister(uint8_t port)
+{
+    return (port == NOT_A_PORT) ? NULL : &_registers[port - PB][0];
+}
+
+volatile MockRegister *portModeRegister(uint8_t port)
+{
+    return (port == NOT_A_PORT) ? NULL : &_registers[port - PB][1];
+}
+
+volatile MockRegister *portOutputRegister(uint8_t port)
+{
+    return (port == NOT_A_PORT) ? NULL : &_registers[port - PB][2];
+}
+
+MockRegister::operator uint8_t() const volatile
+{
+    uint8_t first;
+    uint8_t value = 0;
+
+    if (_type == MOCK_REG_VALUE) {
+        return _value;
+    }
+
+    // A register access takes one HAL call, the same as digitalRead()
+    mockTick(mockCallNs);
+
+    if (_type == MOCK_REG_TCNT0) {
+        return (uint8_t)((mockNs * (F_CPU / 1000000UL)) / (64 * 1000ULL));
+    }
+
+    first = _portFirstPin[_port - PB];
+    for (uint8_t bit = 0; bit < _portNumPins[_port - PB]; bit++) {
+        uint8_t pin = first + bit;
+        uint8_t level;
+
+        if (_type == MOCK_REG_PIN) {
+            level = busLevel(pin);
+        } else if (_type == MOCK_REG_DDR) {
+            level = (_pinMode[pin] == OUTPUT);
+        } else {
+            level = _pinOutput[pin];
+        }
+
+        if (level) {
+            value |= (1 << bit);
+        }
+    }
+
+    return value;
+}
+
+void MockRegister::operator=(uint8_t value) volatile
+{
+    uint8_t first;
+
+    if (_type == MOCK_REG_VALUE) {
+        _value = value;
+        return;
+    }
+
+    mockTick(mockCallNs);
+
+    // Writing the input register toggles the output on AVR targets, which is not simulated. The
+    // Timer0 counter is not written by the library.
+    if ((_type == MOCK_REG_PIN) || (_type == MOCK_REG_TCNT0)) {
+        return;
+    }
+
+    first = _portFirstPin[_port - PB];
+    for (uint8_t bit = 0; bit < _portNumPins[_port - PB]; bit++) {
+        uint8_t pin = first + bit;
+        bool output = (_pinMode[pin] == OUTPUT);
+        uint8_t level = _pinOutput[pin];
+
+        if (_type == MOCK_REG_DDR) {
+            output = ((value & (1 << bit)) != 0);
+        } else {
+            level = (value & (1 << bit)) ? HIGH : LOW;
+        }
+
+        // The output register enables the pull-up of an input, like pinMode()
+        setPin(pin, output ? OUTPUT : (level ? INPUT_PULLUP : INPUT), level);
+    }
+}
@@ -0,0 +1,253 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018-2021 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file Arduino.h
+ * \brief Mock Arduino HAL to build and test the DHT22 library on a Linux host
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDHT22
+ *      Documentation:  https://erriez.github.io/ErriezDHT22
+ *
+ *      Time is simulated: Each HAL call advances the clock by mockCallNs, delay() advances it by
+ *      the requested time. Data pin levels are driven by the DHT22Waveform sensor models.
+ *
+ *      Pin 0..19 have the IO port registers of an Arduino UNO, so the direct GPIO register reads
+ *      of DHT22GpioTraits and DHT22FastPin are used. Pin 20 and higher are only accessible with
+ *      digitalRead() and digitalWrite().
+ */
+
+#ifndef MOCK_ARDUINO_H_
+#define MOCK_ARDUINO_H_
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//! Host build with the mock Arduino HAL
+#define MOCK_ARDUINO
+
+#define HIGH            1
+#define LOW             0
+
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+
+#define CHANGE          1
+#define FALLING         2
+#define RISING          3
+
+//! Number of simulated pins
+#define MOCK_NUM_PINS   64
+
+class __FlashStringHelper;
+#define F(s)                            (reinterpret_cast<const __FlashStringHelper *>(s))
+#define PROGMEM
+#define pgm_read_byte(p)                (*(const uint8_t *)(p))
+#define pgm_read_word(p)                (*(const uint16_t *)(p))
+#define pgm_read_dword(p)               (*(const uint32_t *)(p))
+
+//! Simulated 16 MHz CPU clock
+#define F_CPU                           16000000UL
+#define clockCyclesPerMicrosecond()     (F_CPU / 1000000UL)
+#define microsecondsToClockCycles(a)    ((a) * clockCyclesPerMicrosecond())
+#define digitalPinToInterrupt(p)        (p)
+
+typedef bool boolean;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+void noInterrupts();
+void interrupts();
+void attachInterrupt(uint8_t interruptNum, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+
+//--------------------------------------------------------------------------------------------------
+// IO port registers
+//--------------------------------------------------------------------------------------------------
+//! Pin without IO port registers, read with digitalRead()
+#define NOT_A_PORT      0
+//! IO port B: Arduino UNO pin 8..13
+#define PB              2
+//! IO port C: Arduino UNO pin 14..19 (A0..A5)
+#define PC              3
+//! IO port D: Arduino UNO pin 0..7
+#define PD              4
+
+//! Register type: Value, IO port input, data direction or output register, or Timer0 counter
+#define MOCK_REG_VALUE  0
+#define MOCK_REG_PIN    1
+#define MOCK_REG_DDR    2
+#define MOCK_REG_PORT   3
+#define MOCK_REG_TCNT0  4
+
+/*!
+ * \brief Simulated 8-bit IO port register
+ * \details
+ *      A plain value, such as a bit mask, or an IO port register of the pin map of an Arduino UNO.
+ *      Reading an input register advances the simulated time by mockCallNs and samples the data
+ *      pins, like digitalRead(). Writing a data direction or output register changes the pin
+ *      modes and levels, like pinMode() and digitalWrite(). The Timer0 counter counts the
+ *      simulated time at CPU clock / 64, like the Arduino AVR core.
+ */
+class MockRegister
+{
+public:
+    /*!
+     * \brief Constructor register value.
+     * \param value Value.
+     */
+    MockRegister(uint8_t value = 0) : _port(NOT_A_PORT), _type(MOCK_REG_VALUE), _value(value) { }
+
+    /*!
+     * \brief Constructor IO port register or Timer0 counter.
+     * \param port PB, PC or PD, NOT_A_PORT for MOCK_REG_TCNT0.
+     * \param type MOCK_REG_PIN, MOCK_REG_DDR, MOCK_REG_PORT or MOCK_REG_TCNT0.
+     */
+    MockRegister(uint8_t port, uint8_t type) : _port(port), _type(type), _value(0) { }
+
+    operator uint8_t() const volatile;
+    void operator=(uint8_t value) volatile;
+    //! Read-modify-write OR
+    void operator|=(uint8_t value) volatile { *this = (*this | value); }
+    //! Read-modify-write AND
+    void operator&=(uint8_t value) volatile { *this = (*this & value); }
+
+private:
+    //! IO port, NOT_A_PORT for a value
+    uint8_t _port;
+    //! Register type MOCK_REG_VALUE, MOCK_REG_PIN, MOCK_REG_DDR, MOCK_REG_PORT or MOCK_REG_TCNT0
+    uint8_t _type;
+    //! Value of a MOCK_REG_VALUE register
+    uint8_t _value;
+};
+
+uint8_t digitalPinToPort(uint8_t pin);
+uint8_t digitalPinToBitMask(uint8_t pin);
+volatile MockRegister *portInputRegister(uint8_t port);
+volatile MockRegister *portModeRegister(uint8_t port);
+volatile MockRegister *portOutputRegister(uint8_t port);
+
+#define PINB            (*portInputRegister(PB))
+#define PINC            (*portInputRegister(PC))
+#define PIND            (*portInputRegister(PD))
+
+//! Timer0 counter
+extern volatile MockRegister TCNT0;
+
+//--------------------------------------------------------------------------------------------------
+// Simulation control
+//--------------------------------------------------------------------------------------------------
+/*!
+ * \brief Device connected to a simulated pin, such as a DHT22 sensor model
+ */
+class MockPinDevice
+{
+public:
+    virtual ~MockPinDevice() { }
+
+    /*!
+     * \brief Get the level driven by the device.
+     * \param ns Simulated time in nano seconds.
+     * \return LOW: Device pulls the pin low, HIGH: Device releases the pin.
+     */
+    virtual uint8_t level(uint64_t ns) = 0;
+
+    /*!
+     * \brief The host starts or stops driving the pin low.
+     * \param low true: Host drives the pin low, false: Host releases the pin.
+     * \param ns Simulated time in nano seconds.
+     */
+    virtual void hostDrive(bool low, uint64_t ns) = 0;
+};
+
+//! Simulated time in nano seconds
+extern uint64_t mockNs;
+//! Simulated CPU time of each HAL call in nano seconds
+extern uint32_t mockCallNs;
+//! Simulated interrupt latency in nano seconds
+extern uint32_t mockIsrLatencyNs;
+//! Number of HAL calls
+extern uint64_t mockNumCalls;
+
+//! Connect a device to a pin, NULL disconnects
+void mockConnect(uint8_t pin, MockPinDevice *device);
+//! Advance the simulated time and dispatch pending pin change interrupts
+void mockTick(uint64_t ns);
+//! Check if an interrupt handler is running
+bool mockInIsr();
+//! Get the simulated interrupt handler attached to a pin, or NULL
+void (*mockGetIsr(uint8_t pin))(void);
+//! Set the interrupt flag of a pin, the handler runs when attached with interrupts enabled
+void mockSetPendingInterrupt(uint8_t pin);
+//! Get the pin mode
+uint8_t mockGetPinMode(uint8_t pin);
+//! Get the output level of a pin
+uint8_t mockGetPinOutput(uint8_t pin);
+//! Reset pins, interrupts and the call counter
+void mockReset();
+
+//--------------------------------------------------------------------------------------------------
+// Serial
+//--------------------------------------------------------------------------------------------------
+#define DEC             10
+#define HEX             16
+
+/*!
+ * \brief Serial output to stdout
+ */
+class MockSerial
+{
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    operator bool() { return true; }
+    void flush() { fflush(stdout); }
+
+    void print(const __FlashStringHelper *s) { fputs(reinterpret_cast<const char *>(s), stdout); }
+    void print(const char *s) { fputs(s, stdout); }
+    void print(char c) { putchar(c); }
+    void print(int v, int base = DEC) { printf((base == HEX) ? "%X" : "%d", v); }
+    void print(unsigned int v, int base = DEC) { printf((base == HEX) ? "%X" : "%u", v); }
+    void print(long v, int base = DEC) { printf((base == HEX) ? "%lX" : "%ld", v); }
+    void print(unsigned long v, int base = DEC) { printf((base == HEX) ? "%lX" : "%lu", v); }
+    void print(double v, int digits = 2) { printf("%.*f", digits, v); }
+
+    void println() { putchar('\n'); }
+    template <typename T> void println(T v) { print(v); println(); }
+    template <typename T> void println(T v, int format) { print(v, format); println(); }
+};
+
+extern MockSerial Serial;
+
+#endif // MOCK_ARDUINO_H_